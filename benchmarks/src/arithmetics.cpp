@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+#include "common.hpp"
+#include "matrix.hpp"
+
+namespace
+{
+
+template<typename T>
+struct Operands final
+{
+    std::size_t size;
+    yLab::Matrix<T> lhs;
+    yLab::Matrix<T> rhs;
+
+    explicit Operands (const benchmark::State &state)
+        : size {static_cast<std::size_t>(state.range (0))},
+          lhs {bench::random_matrix<T> (size, size, 1)},
+          rhs {bench::random_matrix<T> (size, size, 2)} {}
+
+    double n_elems () const { return 1.0 * size * size; }
+};
+
+} // unnamed namespace
+
+template<typename T>
+void Add_Assign (benchmark::State &state)
+{
+    Operands<T> ops {state};
+
+    for (auto _ : state)
+    {
+        ops.lhs += ops.rhs;
+        benchmark::ClobberMemory();
+    }
+
+    bench::set_flops (state, ops.n_elems());
+    bench::set_bytes (state, 3 * ops.n_elems() * sizeof (T));
+}
+
+template<typename T>
+void Multiply_Assign (benchmark::State &state)
+{
+    Operands<T> ops {state};
+
+    for (auto _ : state)
+    {
+        ops.lhs *= T{1};
+        benchmark::ClobberMemory();
+    }
+
+    bench::set_flops (state, ops.n_elems());
+    bench::set_bytes (state, 2 * ops.n_elems() * sizeof (T));
+}
+
+// A lazy expression evaluated into an existing matrix in a single pass
+template<typename T>
+void Expression (benchmark::State &state)
+{
+    Operands<T> ops {state};
+    yLab::Matrix<T> result {ops.size, ops.size};
+
+    for (auto _ : state)
+    {
+        result = ops.lhs + ops.rhs * T{2} - ops.lhs;
+        benchmark::ClobberMemory();
+    }
+
+    bench::set_flops (state, 3 * ops.n_elems());
+    bench::set_bytes (state, 4 * ops.n_elems() * sizeof (T));
+}
+
+#define ARITHMETIC_BENCHMARK(name)                                                      \
+    BENCHMARK_TEMPLATE (name, float)->RangeMultiplier (4)->Range (16, 2048);              \
+    BENCHMARK_TEMPLATE (name, double)->RangeMultiplier (4)->Range (16, 2048);             \
+    BENCHMARK_TEMPLATE (name, int)->RangeMultiplier (4)->Range (16, 2048);                \
+    BENCHMARK_TEMPLATE (name, long long)->RangeMultiplier (4)->Range (16, 2048);
+
+ARITHMETIC_BENCHMARK (Add_Assign)
+ARITHMETIC_BENCHMARK (Multiply_Assign)
+ARITHMETIC_BENCHMARK (Expression)
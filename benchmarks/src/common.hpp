@@ -0,0 +1,74 @@
+#ifndef BENCHMARKS_COMMON_HPP
+#define BENCHMARKS_COMMON_HPP
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+#include "matrix.hpp"
+
+namespace bench
+{
+
+// Elements are uniformly distributed in [-1; 1] for floating point types and in [-9; 9] otherwise
+template<typename T>
+yLab::Matrix<T> random_matrix (std::size_t n_rows, std::size_t n_cols, std::uint64_t seed = 42)
+{
+    std::mt19937_64 gen {seed};
+    yLab::Matrix<T> matrix {n_rows, n_cols};
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        std::uniform_real_distribution<T> dist {-1, 1};
+        for (std::size_t i = 0; i != n_rows; ++i)
+            for (std::size_t j = 0; j != n_cols; ++j)
+                matrix[i][j] = dist (gen);
+    }
+    else
+    {
+        std::uniform_int_distribution<int> dist {-9, 9};
+        for (std::size_t i = 0; i != n_rows; ++i)
+            for (std::size_t j = 0; j != n_cols; ++j)
+                matrix[i][j] = static_cast<T>(dist (gen));
+    }
+
+    return matrix;
+}
+
+// Operand of the determinant benchmarks. Bareiss algorithm on a random integral matrix
+// overflows for all but tiny sizes, so integral matrices are unit lower triangular:
+// the algorithm does all its work, but intermediate values stay as they are.
+template<typename T>
+yLab::Matrix<T> determinant_operand (std::size_t size)
+{
+    auto matrix = random_matrix<T> (size, size);
+
+    if constexpr (std::is_integral_v<T>)
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            matrix[i][i] = T{1};
+            for (std::size_t j = i + 1; j != size; ++j)
+                matrix[i][j] = T{};
+        }
+
+    return matrix;
+}
+
+// flops is the number of operations done by one iteration. The rate is reported like
+// bytes_per_second: as FLOP/s in JSON and with an SI prefix (e.g. 6.5G/s) on the console.
+inline void set_flops (benchmark::State &state, double flops)
+{
+    state.counters["flops_per_second"] = benchmark::Counter {flops, benchmark::Counter::kIsIterationInvariantRate};
+}
+
+// bytes is the number of bytes read and written by one iteration
+inline void set_bytes (benchmark::State &state, double bytes)
+{
+    state.SetBytesProcessed (static_cast<std::int64_t>(bytes * state.iterations()));
+}
+
+} // namespace bench
+
+#endif // BENCHMARKS_COMMON_HPP
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "matrix.hpp"
+
+template<typename T>
+void Copy (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto matrix = bench::random_matrix<T> (size, size);
+
+    for (auto _ : state)
+    {
+        yLab::Matrix<T> copy {matrix};
+        benchmark::DoNotOptimize (copy.data());
+    }
+
+    bench::set_bytes (state, 2.0 * size * size * sizeof (T));
+}
+
+template<typename T>
+void Fill_Construct (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+
+    for (auto _ : state)
+    {
+        yLab::Matrix<T> matrix {size, size, T{1}};
+        benchmark::DoNotOptimize (matrix.data());
+    }
+
+    bench::set_bytes (state, 1.0 * size * size * sizeof (T));
+}
+
+// The way drivers used to build matrices: from a range of elements
+template<typename T>
+void Iterator_Construct (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const std::vector<T> elems(size * size, T{1});
+
+    for (auto _ : state)
+    {
+        yLab::Matrix<T> matrix {size, size, elems.begin(), elems.end()};
+        benchmark::DoNotOptimize (matrix.data());
+    }
+
+    bench::set_bytes (state, 2.0 * size * size * sizeof (T));
+}
+
+#define CONSTRUCTION_BENCHMARK(name)                                                    \
+    BENCHMARK_TEMPLATE (name, float)->RangeMultiplier (4)->Range (16, 2048);              \
+    BENCHMARK_TEMPLATE (name, double)->RangeMultiplier (4)->Range (16, 2048);             \
+    BENCHMARK_TEMPLATE (name, int)->RangeMultiplier (4)->Range (16, 2048);                \
+    BENCHMARK_TEMPLATE (name, long long)->RangeMultiplier (4)->Range (16, 2048);
+
+CONSTRUCTION_BENCHMARK (Copy)
+CONSTRUCTION_BENCHMARK (Fill_Construct)
+CONSTRUCTION_BENCHMARK (Iterator_Construct)
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "determinant_tracker.hpp"
+#include "matrix.hpp"
+
+// Gaussian elimination for floating point types, Bareiss algorithm for integral ones.
+// Both do about 2/3 * n^3 operations; the copy of the matrix is included. Integral operands
+// are triangular, so structure detection is skipped.
+template<typename T>
+void Determinant (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto matrix = bench::determinant_operand<T> (size);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.determinant (yLab::structure::General{}));
+
+    bench::set_flops (state, 2.0 / 3.0 * size * size * size);
+    bench::set_bytes (state, 2.0 * size * size * sizeof (T));
+}
+
+BENCHMARK_TEMPLATE (Determinant, float)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Determinant, double)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Determinant, int)->RangeMultiplier (4)->Range (16, 256);
+BENCHMARK_TEMPLATE (Determinant, long long)->RangeMultiplier (4)->Range (16, 256);
+
+// Matrix with bandwidth state.range (1) on both sides of the diagonal. The structure is
+// detected by every call, which then does about 2 * n * b^2 operations instead of 2/3 * n^3.
+template<typename T>
+void Banded_Determinant (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto band = static_cast<std::size_t>(state.range (1));
+
+    auto matrix = bench::random_matrix<T> (size, size);
+    for (std::size_t i = 0; i != size; ++i)
+        for (std::size_t j = 0; j != size; ++j)
+            if (i > j + band || j > i + band)
+                matrix[i][j] = T{};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.determinant());
+
+    bench::set_flops (state, 2.0 * size * band * (2 * band + 1));
+}
+
+BENCHMARK_TEMPLATE (Banded_Determinant, double)->ArgNames ({"n", "band"})
+                                              ->ArgsProduct ({{256, 1024}, {1, 4, 16}});
+
+// The same unchanged matrix is asked for its determinant over and over. With YLAB_DET_CACHE
+// every call but the first one returns the cached value; otherwise each call does the whole work.
+template<typename T>
+void Repeated_Determinant (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto matrix = bench::determinant_operand<T> (size);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.determinant());
+}
+
+BENCHMARK_TEMPLATE (Repeated_Determinant, double)->RangeMultiplier (4)->Range (64, 1024);
+
+// Symmetric diagonally dominant matrix, which is positive definite: determinant() takes
+// Cholesky decomposition with n^3 / 3 operations, structure::General hint doesn't change that
+template<typename T>
+void Symmetric_Determinant (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+
+    auto matrix = bench::random_matrix<T> (size, size);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        for (std::size_t j = 0; j != i; ++j)
+            matrix[i][j] = matrix[j][i];
+        matrix[i][i] = static_cast<T>(size);
+    }
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.determinant());
+
+    bench::set_flops (state, 1.0 / 3.0 * size * size * size);
+    bench::set_bytes (state, 2.0 * size * size * sizeof (T));
+}
+
+BENCHMARK_TEMPLATE (Symmetric_Determinant, float)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Symmetric_Determinant, double)->RangeMultiplier (4)->Range (16, 1024);
+
+// Replacement of a row and the new determinant: O(n^2) updates of the inverse, with
+// the refactorization every tracker_refactor_interval updates included
+void Tracked_Row_Update (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto matrix = bench::determinant_operand<double> (size);
+    yLab::Determinant_Tracker tracker {matrix};
+
+    const auto other = bench::random_matrix<double> (size, size, 7);
+    std::vector<double> new_row (size);
+
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        for (std::size_t j = 0; j != size; ++j)
+            new_row[j] = other[i][j];
+        benchmark::DoNotOptimize (tracker.replace_row (i, new_row));
+        i = (i + 1) % size;
+    }
+}
+
+BENCHMARK (Tracked_Row_Update)->RangeMultiplier (4)->Range (16, 1024);
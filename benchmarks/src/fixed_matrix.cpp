@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+#include "common.hpp"
+#include "fixed_matrix.hpp"
+#include "matrix.hpp"
+
+// Small matrices of fixed and dynamic size side by side. The operand is passed through
+// DoNotOptimize on every iteration, so that nothing is computed at compile time.
+
+template<typename T, std::size_t N>
+void Fixed_Determinant (benchmark::State &state)
+{
+    yLab::Fixed_Matrix<T, N, N> matrix {bench::determinant_operand<T> (N)};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize (matrix);
+        benchmark::DoNotOptimize (matrix.determinant());
+    }
+}
+
+template<typename T, std::size_t N>
+void Dynamic_Determinant (benchmark::State &state)
+{
+    const auto matrix = bench::determinant_operand<T> (N);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.determinant());
+}
+
+template<typename T, std::size_t N>
+void Fixed_Product (benchmark::State &state)
+{
+    yLab::Fixed_Matrix<T, N, N> lhs {bench::random_matrix<T> (N, N, 1)};
+    yLab::Fixed_Matrix<T, N, N> rhs {bench::random_matrix<T> (N, N, 2)};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize (lhs);
+        benchmark::DoNotOptimize (product (lhs, rhs));
+    }
+
+    bench::set_flops (state, 2.0 * N * N * N);
+}
+
+template<typename T, std::size_t N>
+void Dynamic_Product (benchmark::State &state)
+{
+    const auto lhs = bench::random_matrix<T> (N, N, 1);
+    const auto rhs = bench::random_matrix<T> (N, N, 2);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (product (lhs, rhs));
+
+    bench::set_flops (state, 2.0 * N * N * N);
+}
+
+BENCHMARK_TEMPLATE (Fixed_Determinant, double, 2);
+BENCHMARK_TEMPLATE (Fixed_Determinant, double, 3);
+BENCHMARK_TEMPLATE (Fixed_Determinant, double, 4);
+BENCHMARK_TEMPLATE (Fixed_Determinant, double, 8);
+BENCHMARK_TEMPLATE (Fixed_Determinant, long long, 4);
+BENCHMARK_TEMPLATE (Fixed_Determinant, long long, 8);
+
+BENCHMARK_TEMPLATE (Dynamic_Determinant, double, 2);
+BENCHMARK_TEMPLATE (Dynamic_Determinant, double, 3);
+BENCHMARK_TEMPLATE (Dynamic_Determinant, double, 4);
+BENCHMARK_TEMPLATE (Dynamic_Determinant, double, 8);
+BENCHMARK_TEMPLATE (Dynamic_Determinant, long long, 4);
+BENCHMARK_TEMPLATE (Dynamic_Determinant, long long, 8);
+
+BENCHMARK_TEMPLATE (Fixed_Product, double, 2);
+BENCHMARK_TEMPLATE (Fixed_Product, double, 4);
+BENCHMARK_TEMPLATE (Fixed_Product, double, 8);
+
+BENCHMARK_TEMPLATE (Dynamic_Product, double, 2);
+BENCHMARK_TEMPLATE (Dynamic_Product, double, 4);
+BENCHMARK_TEMPLATE (Dynamic_Product, double, 8);
@@ -0,0 +1,6 @@
+#include <benchmark/benchmark.h>
+
+// Every benchmark reports flops_per_second and bytes_per_second counters where they make sense.
+// Machine-readable results: benchmarks --benchmark_out=results.json --benchmark_out_format=json
+// or "cmake --build <build_dir> --target run_benchmarks".
+BENCHMARK_MAIN ();
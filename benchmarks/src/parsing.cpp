@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "common.hpp"
+#include "matrix.hpp"
+#include "matrix_file.hpp"
+#include "matrix_reader.hpp"
+
+namespace
+{
+
+// Input of the drivers: the size and then the elements
+template<typename T>
+std::string matrix_text (std::size_t size)
+{
+    std::ostringstream os;
+    os << size << '\n' << bench::random_matrix<T> (size, size);
+    return os.str();
+}
+
+} // unnamed namespace
+
+template<typename T>
+void Parse_Text (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto text = matrix_text<T> (size);
+
+    for (auto _ : state)
+    {
+        std::istringstream is {text};
+        benchmark::DoNotOptimize (yLab::read_matrix<T> (is));
+    }
+
+    state.SetItemsProcessed (state.iterations() * size * size);
+    bench::set_bytes (state, text.size());
+}
+
+// Formatted extraction of every element: the baseline for Parse_Text
+template<typename T>
+void Parse_Text_Istream (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto text = matrix_text<T> (size);
+
+    for (auto _ : state)
+    {
+        std::istringstream is {text};
+        std::size_t n;
+        is >> n;
+        yLab::Matrix<T> matrix {n, n, std::istream_iterator<T>{is}, std::istream_iterator<T>{}};
+        benchmark::DoNotOptimize (matrix.data());
+    }
+
+    state.SetItemsProcessed (state.iterations() * size * size);
+    bench::set_bytes (state, text.size());
+}
+
+// Mapping of a binary matrix file and copying of the view into a matrix
+template<typename T>
+void Load_Binary (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto path = (std::filesystem::temp_directory_path() / "ylab_benchmark.mx").string();
+    {
+        std::ofstream file {path, std::ios::binary};
+        yLab::write_binary (file, bench::random_matrix<T> (size, size));
+    }
+
+    for (auto _ : state)
+    {
+        yLab::Matrix_File file {path};
+        yLab::Matrix<T> matrix {file.view<T>()};
+        benchmark::DoNotOptimize (matrix.data());
+    }
+
+    std::remove (path.c_str());
+
+    state.SetItemsProcessed (state.iterations() * size * size);
+    bench::set_bytes (state, 1.0 * size * size * sizeof (T));
+}
+
+BENCHMARK_TEMPLATE (Parse_Text, double)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Parse_Text, long long)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Parse_Text_Istream, double)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Parse_Text_Istream, long long)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Load_Binary, double)->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK_TEMPLATE (Load_Binary, long long)->RangeMultiplier (4)->Range (16, 1024);
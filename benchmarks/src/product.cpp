@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+#include "common.hpp"
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+// {m, k, n}: (m x k) * (k x n) for square, tall-skinny times short-wide and inner-product-like shapes
+void product_shapes (benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames ({"m", "k", "n"});
+    for (long size : {16, 64, 256, 512})
+    {
+        bench->Args ({size, size, size});
+        bench->Args ({4 * size, size / 4, 4 * size});
+        bench->Args ({size / 4, 4 * size, size / 4});
+    }
+}
+
+template<typename T, typename Policy>
+void run_product (benchmark::State &state, Policy policy)
+{
+    const auto m = static_cast<std::size_t>(state.range (0));
+    const auto k = static_cast<std::size_t>(state.range (1));
+    const auto n = static_cast<std::size_t>(state.range (2));
+
+    const auto lhs = bench::random_matrix<T> (m, k, 1);
+    const auto rhs = bench::random_matrix<T> (k, n, 2);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (yLab::product (policy, lhs, rhs));
+
+    bench::set_flops (state, 2.0 * m * k * n);
+    bench::set_bytes (state, (1.0 * m * k + 1.0 * k * n + 1.0 * m * n) * sizeof (T));
+}
+
+} // unnamed namespace
+
+template<typename T>
+void Product (benchmark::State &state) { run_product<T> (state, yLab::execution::seq); }
+
+template<typename T>
+void Parallel_Product (benchmark::State &state) { run_product<T> (state, yLab::execution::par); }
+
+// Product of a matrix and a transposed view goes through strided packing
+template<typename T>
+void Product_Transposed (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+
+    const auto lhs = bench::random_matrix<T> (size, size, 1);
+    const auto rhs = bench::random_matrix<T> (size, size, 2);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (yLab::product (lhs, rhs.transposed()));
+
+    bench::set_flops (state, 2.0 * size * size * size);
+    bench::set_bytes (state, 3.0 * size * size * sizeof (T));
+}
+
+// Square products by Strassen-Winograd algorithm for {size, cutoff}. flops_per_second counts
+// the 2 * n^3 operations of the classical algorithm, so that it compares with Product.
+template<typename T>
+void Strassen_Product (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const yLab::algorithm::Strassen strassen {static_cast<std::size_t>(state.range (1))};
+
+    const auto lhs = bench::random_matrix<T> (size, size, 1);
+    const auto rhs = bench::random_matrix<T> (size, size, 2);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (yLab::product (lhs, rhs, strassen));
+
+    bench::set_flops (state, 2.0 * size * size * size);
+    bench::set_bytes (state, 3.0 * size * size * sizeof (T));
+}
+
+void strassen_shapes (benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames ({"n", "cutoff"});
+    for (long size : {512, 1024, 2048})
+        for (long cutoff : {64, 128, 256})
+            bench->Args ({size, cutoff});
+}
+
+BENCHMARK_TEMPLATE (Product, float)->Apply (product_shapes);
+BENCHMARK_TEMPLATE (Product, double)->Apply (product_shapes);
+BENCHMARK_TEMPLATE (Product, int)->Apply (product_shapes);
+BENCHMARK_TEMPLATE (Product, long long)->Apply (product_shapes);
+
+BENCHMARK_TEMPLATE (Parallel_Product, double)->Apply (product_shapes)->UseRealTime();
+
+BENCHMARK_TEMPLATE (Strassen_Product, double)->Apply (strassen_shapes)->Unit (benchmark::kMillisecond);
+BENCHMARK_TEMPLATE (Strassen_Product, long long)->Apply (strassen_shapes)->Unit (benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE (Product_Transposed, double)->RangeMultiplier (4)->Range (16, 512);
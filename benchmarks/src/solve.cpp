@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "lu.hpp"
+#include "mixed_lu.hpp"
+
+namespace
+{
+
+// Diagonally dominant, so mixed precision refinement converges in a few steps
+yLab::Matrix<double> solve_operand (std::size_t size)
+{
+    auto matrix = bench::random_matrix<double> (size, size);
+    for (std::size_t i = 0; i != size; ++i)
+        matrix[i][i] += static_cast<double>(size) / 4;
+    return matrix;
+}
+
+} // unnamed namespace
+
+// Decomposition and one solve; both take about 2/3 * n^3 operations
+void Solve (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto matrix = solve_operand (size);
+    const std::vector<double> rhs (size, 1.0);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.lu().solve (rhs));
+
+    bench::set_flops (state, 2.0 / 3.0 * size * size * size);
+}
+
+void Mixed_Precision_Solve (benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range (0));
+    const auto matrix = solve_operand (size);
+    const std::vector<double> rhs (size, 1.0);
+
+    std::size_t n_steps = 0;
+    for (auto _ : state)
+    {
+        auto result = matrix.mixed_lu().solve (rhs);
+        n_steps = result.n_steps;
+        benchmark::DoNotOptimize (result);
+    }
+
+    state.counters["refinement_steps"] = static_cast<double>(n_steps);
+    bench::set_flops (state, 2.0 / 3.0 * size * size * size);
+}
+
+BENCHMARK (Solve)->RangeMultiplier (4)->Range (64, 1024)->Unit (benchmark::kMicrosecond);
+BENCHMARK (Mixed_Precision_Solve)->RangeMultiplier (4)->Range (64, 1024)->Unit (benchmark::kMicrosecond);
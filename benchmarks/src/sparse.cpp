@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <vector>
+
+#include "sparse_lu.hpp"
+#include "sparse_matrix.hpp"
+
+namespace
+{
+
+// 5-point Laplacian of a grid x grid mesh: n = grid^2 rows with at most 5 nonzeros each
+yLab::CSR_Matrix<double> laplacian (std::size_t grid)
+{
+    std::vector<yLab::Triplet<double>> entries;
+    for (std::size_t i = 0; i != grid; ++i)
+        for (std::size_t j = 0; j != grid; ++j)
+        {
+            const auto v = i * grid + j;
+            entries.push_back ({v, v, 4.01});
+            if (i != 0)        entries.push_back ({v, v - grid, -1.0});
+            if (i + 1 != grid) entries.push_back ({v, v + grid, -1.0});
+            if (j != 0)        entries.push_back ({v, v - 1, -1.0});
+            if (j + 1 != grid) entries.push_back ({v, v + 1, -1.0});
+        }
+
+    return {grid * grid, grid * grid, entries};
+}
+
+} // unnamed namespace
+
+void Sparse_Matrix_Vector_Product (benchmark::State &state)
+{
+    const auto matrix = laplacian (static_cast<std::size_t>(state.range (0)));
+    const std::vector<double> x (matrix.n_cols(), 1.0);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (product (matrix, x));
+
+    state.counters["nnz"] = static_cast<double>(matrix.nnz());
+    state.SetItemsProcessed (state.iterations() * static_cast<long>(matrix.nnz()));
+}
+
+void Sparse_Matrix_Matrix_Product (benchmark::State &state)
+{
+    const auto matrix = laplacian (static_cast<std::size_t>(state.range (0)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (product (matrix, matrix));
+
+    state.counters["nnz"] = static_cast<double>(matrix.nnz());
+}
+
+// Ordering and factorization; fill is the number of nonzeros of L and U per nonzero of A
+void Sparse_Determinant (benchmark::State &state)
+{
+    const auto matrix = laplacian (static_cast<std::size_t>(state.range (0)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (matrix.determinant());
+
+    state.counters["nnz"] = static_cast<double>(matrix.nnz());
+    state.counters["fill"] = static_cast<double>(matrix.lu().nnz()) / static_cast<double>(matrix.nnz());
+}
+
+BENCHMARK (Sparse_Matrix_Vector_Product)->ArgName ("grid")->RangeMultiplier (4)->Range (16, 1024);
+BENCHMARK (Sparse_Matrix_Matrix_Product)->ArgName ("grid")->RangeMultiplier (4)->Range (16, 256);
+BENCHMARK (Sparse_Determinant)->ArgName ("grid")->RangeMultiplier (2)->Range (16, 128)
+                              ->Unit (benchmark::kMillisecond);
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+#include "common.hpp"
+#include "matrix.hpp"
+
+namespace
+{
+
+// {n_rows, n_cols}: square, wide and tall matrices
+void transpose_shapes (benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames ({"rows", "cols"});
+    for (long size : {64, 256, 1024, 2048})
+    {
+        bench->Args ({size, size});
+        bench->Args ({size / 4, 4 * size});
+        bench->Args ({4 * size, size / 4});
+    }
+}
+
+} // unnamed namespace
+
+// In place for square matrices, through a cache-oblivious copy otherwise.
+// Each iteration transposes the result of the previous one, so shapes alternate.
+template<typename T>
+void Transpose (benchmark::State &state)
+{
+    const auto n_rows = static_cast<std::size_t>(state.range (0));
+    const auto n_cols = static_cast<std::size_t>(state.range (1));
+    auto matrix = bench::random_matrix<T> (n_rows, n_cols);
+
+    for (auto _ : state)
+    {
+        matrix.transpose();
+        benchmark::ClobberMemory();
+    }
+
+    bench::set_bytes (state, 2.0 * n_rows * n_cols * sizeof (T));
+}
+
+// Cycle-following transposition without a second buffer
+template<typename T>
+void Transpose_In_Place (benchmark::State &state)
+{
+    const auto n_rows = static_cast<std::size_t>(state.range (0));
+    const auto n_cols = static_cast<std::size_t>(state.range (1));
+    auto matrix = bench::random_matrix<T> (n_rows, n_cols);
+
+    for (auto _ : state)
+    {
+        matrix.transpose_in_place();
+        benchmark::ClobberMemory();
+    }
+
+    bench::set_bytes (state, 2.0 * n_rows * n_cols * sizeof (T));
+}
+
+BENCHMARK_TEMPLATE (Transpose, float)->Apply (transpose_shapes);
+BENCHMARK_TEMPLATE (Transpose, double)->Apply (transpose_shapes);
+BENCHMARK_TEMPLATE (Transpose, int)->Apply (transpose_shapes);
+BENCHMARK_TEMPLATE (Transpose, long long)->Apply (transpose_shapes);
+
+BENCHMARK_TEMPLATE (Transpose_In_Place, double)->Apply (transpose_shapes);
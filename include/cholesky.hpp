@@ -0,0 +1,128 @@
+#ifndef INCLUDE_CHOLESKY_HPP
+#define INCLUDE_CHOLESKY_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "cholesky_kernel.hpp"
+#include "floating_point_comparison.hpp"
+#include "lu.hpp"
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+struct Undef_Cholesky final : public Undef_Operation
+{
+    Undef_Cholesky()
+        : Undef_Operation{"Cholesky decomposition is not defined for non-square matrices"} {};
+};
+
+struct Not_Positive_Definite final : public Undef_Operation
+{
+    Not_Positive_Definite() : Undef_Operation{"The matrix is not positive definite"} {};
+};
+
+// Cholesky decomposition A = L * L^T of a symmetric positive definite matrix, such as
+// a covariance or a Gram matrix. Only the upper triangle of A is read, and U = L^T is
+// stored. The decomposition costs n^3 / 3 operations, half as many as LU; then
+// determinant() and log_determinant() are O(n) and solve() is O(n^2) per right-hand side.
+template<typename T, typename Allocator>
+class Cholesky final
+{
+    static_assert(std::is_floating_point_v<T>,
+                  "Cholesky decomposition requires a floating-point type");
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using matrix_type = Matrix<T, Allocator>;
+    using allocator_type = Allocator;
+
+    // Throws Not_Positive_Definite if a pivot isn't positive. The factor and the results
+    // of solve() use the allocator of the matrix.
+    explicit Cholesky(const matrix_type &matrix)
+        : factor_{matrix, matrix.get_allocator()}
+    {
+        if (!matrix.is_square())
+            throw Undef_Cholesky{};
+
+        if (!detail::cholesky_decompose(Thread_Pool::default_pool(),
+                                        size(), factor_.data(), factor_.stride()))
+            throw Not_Positive_Definite{};
+    }
+
+    size_type size() const noexcept { return factor_.n_rows(); }
+
+    allocator_type get_allocator() const noexcept { return factor_.get_allocator(); }
+
+    value_type determinant() const
+    {
+        const value_type determinant =
+            detail::cholesky_determinant(size(), factor_.data(), factor_.stride());
+
+        if (yLab::cmp::are_equal(determinant, value_type{}))
+            return value_type{};
+        return determinant;
+    }
+
+    // The determinant of a large covariance matrix often overflows or underflows,
+    // while its logarithm doesn't
+    value_type log_determinant() const
+    {
+        return detail::cholesky_log_determinant(size(), factor_.data(), factor_.stride());
+    }
+
+    // Solves A * X = B for every column of B
+    matrix_type solve(const matrix_type &rhs) const
+    {
+        if (rhs.n_rows() != size())
+            throw Undef_Solve{};
+
+        matrix_type solution{rhs, get_allocator()};
+        detail::cholesky_solve(size(), factor_.data(), factor_.stride(),
+                               solution.n_cols(), solution.data(), solution.stride());
+        return solution;
+    }
+
+    // Solves A * x = b
+    std::vector<T> solve(const std::vector<T> &rhs) const
+    {
+        if (rhs.size() != size())
+            throw Undef_Solve{};
+
+        std::vector<T> solution = rhs;
+        detail::cholesky_solve(size(), factor_.data(), factor_.stride(),
+                               1, solution.data(), 1);
+        return solution;
+    }
+
+    // L; its strictly upper triangle is zero
+    matrix_type factor() const
+    {
+        matrix_type lower{size(), size(), value_type{}, get_allocator()};
+        for (size_type i = 0; i != size(); ++i)
+            for (size_type j = i; j != size(); ++j)
+                lower[j][i] = factor_[i][j];
+        return lower;
+    }
+
+private:
+
+    matrix_type factor_;
+};
+
+template<typename T, typename Allocator>
+requires std::is_arithmetic_v<T>
+Cholesky<T, Allocator> Matrix<T, Allocator>::cholesky() const requires std::is_floating_point_v<T>
+{
+    return Cholesky<T, Allocator>{*this};
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_CHOLESKY_HPP
@@ -0,0 +1,203 @@
+#ifndef INCLUDE_CHOLESKY_KERNEL_HPP
+#define INCLUDE_CHOLESKY_KERNEL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+
+#include "gemm.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// Matrices of at least that size are decomposed by blocks, if there are several threads
+inline constexpr std::size_t cholesky_blocked_threshold = 512;
+
+// Rows of the matrix are factorized by blocks of that height
+inline constexpr std::size_t cholesky_block_size = 64;
+
+// Cholesky decomposition of the height x width block row [k, k + height) x [k, k + width)
+// whose trailing part has been updated by all the block rows above it. Row j of U is row j
+// of A divided by u_jj, and every row below it loses u_ji times it from column i on, so
+// each step is a SIMD row operation, as in lu_decompose(). Columns to the right of
+// the diagonal block get U_12 = U_11^-T * A_12 on the way.
+// Returns false if a pivot isn't positive.
+template<std::floating_point T>
+bool cholesky_rows(std::size_t height, std::size_t width, T *a, std::size_t lda)
+{
+    for (std::size_t j = 0; j != height; ++j)
+    {
+        T *row_j = a + j * lda;
+
+        // The negation catches NaN as well
+        if (!(row_j[j] > T{}))
+            return false;
+
+        const T u_jj = std::sqrt(row_j[j]);
+        row_j[j] = u_jj;
+        simd::divide(width - j - 1, row_j + j + 1, u_jj);
+
+        for (std::size_t i = j + 1; i != height; ++i)
+            simd::sub_scaled(width - i, a + i * lda + i, row_j + i, row_j[i]);
+    }
+
+    return true;
+}
+
+// In-place Cholesky decomposition A = U^T * U (= L * L^T with L = U^T) of a symmetric
+// n x n row-major matrix. Only the upper triangle is read, and U overwrites it; the strictly
+// lower triangle isn't touched. It takes n^3 / 3 operations, half as many as LU
+// decomposition, with no pivot search.
+//
+// Returns false if A isn't positive definite, which is detected by a pivot that isn't
+// positive: it's met at the first step where a leading minor isn't positive.
+template<std::floating_point T>
+bool cholesky_decompose(std::size_t n, T *a, std::size_t lda)
+{
+    return cholesky_rows(n, n, a, lda);
+}
+
+// Blocked version of the above: after a block row is factorized, the block rows of
+// the trailing upper triangle are updated by GEMM in parallel. Row operations of SIMD
+// kernels outrun the sequential GEMM, so small matrices and a pool of one thread go
+// to the unblocked version instead.
+template<std::floating_point T>
+bool cholesky_decompose(Thread_Pool &pool, std::size_t n, T *a, std::size_t lda,
+                        std::size_t block_size = cholesky_block_size)
+{
+    if (pool.n_threads() == 1 || n < cholesky_blocked_threshold)
+        return cholesky_decompose(n, a, lda);
+
+    for (std::size_t k = 0; k < n; k += block_size)
+    {
+        const auto height = std::min(block_size, n - k);
+        if (!cholesky_rows(height, n - k, a + k * lda + k, lda))
+            return false;
+
+        // A_22 -= U_12^T * U_12 in the upper triangle: block row [first, last) is updated
+        // to the right of its diagonal block by GEMM, and the diagonal block row by row
+        const auto trailing = k + height;
+        const T *u_12 = a + k * lda + trailing;
+
+        pool.parallel_for((n - trailing + block_size - 1) / block_size, [=](std::size_t block)
+        {
+            const auto first = trailing + block * block_size;
+            const auto last = std::min(first + block_size, n);
+
+            for (auto row = first; row != last; ++row)
+                gemm_strided(std::size_t{1}, last - row, height,
+                             u_12 + (row - trailing), std::size_t{1}, lda,
+                             u_12 + (row - trailing), lda, std::size_t{1},
+                             a + row * lda + row, lda, T{-1});
+
+            if (last != n)
+                gemm_strided(last - first, n - last, height,
+                             u_12 + (first - trailing), std::size_t{1}, lda,
+                             u_12 + (last - trailing), lda, std::size_t{1},
+                             a + first * lda + last, lda, T{-1});
+        });
+    }
+
+    return true;
+}
+
+// Logarithm of the determinant of a matrix decomposed by cholesky_decompose(). Unlike
+// the determinant itself, it doesn't overflow for large matrices.
+template<std::floating_point T>
+T cholesky_log_determinant(std::size_t n, const T *a, std::size_t lda)
+{
+    T sum{};
+    for (std::size_t i = 0; i != n; ++i)
+        sum += std::log(a[i * (lda + 1)]);
+    return 2 * sum;
+}
+
+// Determinant of a matrix decomposed by cholesky_decompose()
+template<std::floating_point T>
+T cholesky_determinant(std::size_t n, const T *a, std::size_t lda)
+{
+    T determinant{1};
+    for (std::size_t i = 0; i != n; ++i)
+        determinant *= a[i * (lda + 1)];
+    return determinant * determinant;
+}
+
+// Solves U^T * U * X = B in place for n_rhs right-hand sides: x holds B on entry and X
+// on exit. Takes 2 * n^2 operations per right-hand side.
+template<std::floating_point T>
+void cholesky_solve(std::size_t n, const T *a, std::size_t lda,
+                    std::size_t n_rhs, T *x, std::size_t ldx)
+{
+    // Forward substitution with U^T: row k of U is column k of U^T
+    for (std::size_t k = 0; k != n; ++k)
+    {
+        const T *u_row = a + k * lda;
+        T *x_k = x + k * ldx;
+
+        const T u_kk = u_row[k];
+        for (std::size_t j = 0; j != n_rhs; ++j)
+            x_k[j] /= u_kk;
+
+        for (std::size_t i = k + 1; i != n; ++i)
+        {
+            const T u_ki = u_row[i];
+            T *x_i = x + i * ldx;
+            for (std::size_t j = 0; j != n_rhs; ++j)
+                x_i[j] -= u_ki * x_k[j];
+        }
+    }
+
+    // Back substitution with U
+    for (std::size_t i = n; i-- != 0;)
+    {
+        const T *u_row = a + i * lda;
+        T *x_i = x + i * ldx;
+
+        for (std::size_t k = i + 1; k != n; ++k)
+        {
+            const T u_ik = u_row[k];
+            const T *x_k = x + k * ldx;
+            for (std::size_t j = 0; j != n_rhs; ++j)
+                x_i[j] -= u_ik * x_k[j];
+        }
+
+        const T u_ii = u_row[i];
+        for (std::size_t j = 0; j != n_rhs; ++j)
+            x_i[j] /= u_ii;
+    }
+}
+
+// Whether all diagonal elements are positive, as they are in a positive definite matrix:
+// an O(n) check which rejects many symmetric matrices before an O(n^3) decomposition
+template<typename T>
+bool has_positive_diagonal(std::size_t n, const T *a, std::size_t lda) noexcept
+{
+    for (std::size_t i = 0; i != n; ++i)
+        if (!(a[i * (lda + 1)] > T{}))
+            return false;
+    return true;
+}
+
+// Whether the n x n matrix equals its transpose exactly. A general matrix usually differs
+// from it in the first few elements, so the check is cheap for the matrices it rejects.
+template<typename T>
+bool is_symmetric(std::size_t n, const T *a, std::size_t lda) noexcept
+{
+    for (std::size_t i = 1; i < n; ++i)
+        for (std::size_t j = 0; j != i; ++j)
+            if (a[i * lda + j] != a[j * lda + i])
+                return false;
+    return true;
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_CHOLESKY_KERNEL_HPP
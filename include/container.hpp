@@ -4,33 +4,88 @@
 #include <cstddef>
 #include <initializer_list>
 #include <memory>
+#include <new>
 #include <iterator>
 #include <utility>
 
+#include "stats.hpp"
+
 namespace yLab
 {
 
-template<typename T>
+// Requests default-initialization of elements, which leaves arithmetic types uninitialized
+struct Default_Init_Tag final {};
+inline constexpr Default_Init_Tag default_init{};
+
+// Allocates storage aligned to Alignment bytes. Matrix pads its rows to a multiple
+// of the alignment when given this allocator, see Matrix::stride().
+template<typename T, std::size_t Alignment = 64>
+struct Aligned_Allocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0 && Alignment >= alignof(T),
+                  "Alignment must be a power of 2 not less than the alignment of T");
+
+    using value_type = T;
+    static constexpr std::size_t alignment = Alignment;
+
+    template<typename U>
+    struct rebind { using other = Aligned_Allocator<U, Alignment>; };
+
+    Aligned_Allocator() noexcept = default;
+
+    template<typename U>
+    Aligned_Allocator(const Aligned_Allocator<U, Alignment> &) noexcept {}
+
+    T *allocate(std::size_t count)
+    {
+        return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T *ptr, std::size_t) noexcept
+    {
+        ::operator delete(ptr, std::align_val_t{Alignment});
+    }
+
+    friend bool operator==(const Aligned_Allocator &, const Aligned_Allocator &) noexcept
+    {
+        return true;
+    }
+};
+
+// Storage is obtained from Allocator, so with std::pmr::polymorphic_allocator it may come
+// from any std::pmr::memory_resource, e.g. a monotonic arena released all at once
+template<typename T, typename Allocator = std::allocator<T>>
 class Buffer
 {
+protected:
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+
 public:
 
     using value_type = T;
+    using allocator_type = Allocator;
     using reference = T &;
     using const_reference = const T &;
     using pointer = T *;
     using const_pointer = T *;
     using size_type = std::size_t;
 
-    Buffer(size_type count)
-        : data_{count == 0 ? nullptr : static_cast<T *>(::operator new(count * sizeof(T)))},
-          capacity_{count} {}
+    Buffer(size_type count, const Allocator &alloc = Allocator{})
+        : alloc_{alloc},
+          data_{count == 0 ? nullptr : alloc_traits::allocate(alloc_, count)},
+          capacity_{count}
+    {
+        if (data_)
+            stats::count_allocation();
+    }
 
     Buffer(const Buffer &) = delete;
     Buffer &operator=(const Buffer &) = delete;
 
     Buffer(Buffer &&rhs) noexcept
-        : data_{std::exchange(rhs.data_, nullptr)},
+        : alloc_{std::move(rhs.alloc_)},
+          data_{std::exchange(rhs.data_, nullptr)},
           capacity_{std::exchange(rhs.capacity_, 0)},
           size_{std::exchange(rhs.size_, 0)} {}
 
@@ -40,76 +95,139 @@ public:
         return *this;
     }
 
+    // As for standard containers, allocators that don't propagate on swap must compare equal
     void swap(Buffer &rhs) noexcept
     {
-        std::swap(data_, rhs.data_);
-        std::swap(capacity_, rhs.capacity_);
-        std::swap(size_, rhs.size_);
+        if constexpr (alloc_traits::propagate_on_container_swap::value)
+            std::swap(alloc_, rhs.alloc_);
+        swap_storage(rhs);
     }
 
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
 protected:
 
     ~Buffer()
     {
-        std::destroy(data_, data_ + size_);
-        ::operator delete(data_);
+        for (size_type i = 0; i != size_; ++i)
+            alloc_traits::destroy(alloc_, data_ + i);
+        if (data_)
+            alloc_traits::deallocate(alloc_, data_, capacity_);
+    }
+
+    void swap_storage(Buffer &rhs) noexcept
+    {
+        std::swap(data_, rhs.data_);
+        std::swap(capacity_, rhs.capacity_);
+        std::swap(size_, rhs.size_);
     }
 
+    [[no_unique_address]] Allocator alloc_;
     T *data_;
     size_type capacity_;
     size_type size_ = 0;
 };
 
-template<typename T>
-class Array : private Buffer<T> {
-    using Buffer<T>::data_;
-    using Buffer<T>::size_;
-    using Buffer<T>::capacity_;
+template<typename T, typename Allocator = std::allocator<T>>
+class Array : private Buffer<T, Allocator> {
+    using Base = Buffer<T, Allocator>;
+    using typename Base::alloc_traits;
+    using Base::alloc_;
+    using Base::data_;
+    using Base::size_;
+    using Base::capacity_;
+    using Base::swap_storage;
 
 public:
-    using typename Buffer<T>::value_type;
-    using typename Buffer<T>::reference;
-    using typename Buffer<T>::const_reference;
-    using typename Buffer<T>::pointer;
-    using typename Buffer<T>::const_pointer;
-    using typename Buffer<T>::size_type;
+    using typename Base::value_type;
+    using typename Base::allocator_type;
+    using typename Base::reference;
+    using typename Base::const_reference;
+    using typename Base::pointer;
+    using typename Base::const_pointer;
+    using typename Base::size_type;
 
     using iterator = pointer;
     using const_iterator = const_pointer;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    using Buffer<T>::swap;
+    using Base::swap;
+    using Base::get_allocator;
 
     template<std::forward_iterator It>
-    Array(It first, It last) : Buffer<T>{static_cast<size_type>(std::distance(first, last))}
+    Array(It first, It last, const Allocator &alloc = Allocator{})
+        : Base{static_cast<size_type>(std::distance(first, last)), alloc}
     {
         for (; first != last; ++first, ++size_)
-            std::construct_at(data_ + size_, *first);
+            alloc_traits::construct(alloc_, data_ + size_, *first);
     }
 
-    Array(std::initializer_list<T> ilist) : Array(ilist.begin(), ilist.end()) {}
+    Array(std::initializer_list<T> ilist, const Allocator &alloc = Allocator{})
+        : Array(ilist.begin(), ilist.end(), alloc) {}
 
-    Array(size_type count) : Buffer<T>{count}
+    Array(size_type count, const Allocator &alloc = Allocator{}) : Base{count, alloc}
     {
         for (; size_ != count; ++size_)
-            std::construct_at(data_ + size_, T{});
+            alloc_traits::construct(alloc_, data_ + size_, T{});
     }
 
-    Array(size_type count, const value_type &value) : Buffer<T>{count}
+    Array(size_type count, const value_type &value, const Allocator &alloc = Allocator{})
+        : Base{count, alloc}
     {
         for (; size_ != count; ++size_)
-            std::construct_at(data_ + size_, value);
+            alloc_traits::construct(alloc_, data_ + size_, value);
     }
 
-    Array(const Array &rhs) : Buffer<T>{rhs.capacity_} {
-        for (; size_ != capacity_; ++size_)
-            std::construct_at(data_ + size_, rhs.data_[size_]);
+    Array(size_type count, Default_Init_Tag, const Allocator &alloc = Allocator{})
+        : Base{count, alloc}
+    {
+        for (; size_ != count; ++size_)
+            ::new (static_cast<void *>(data_ + size_)) T;
     }
 
+    Array(const Array &rhs)
+        : Array(rhs, alloc_traits::select_on_container_copy_construction(rhs.alloc_)) {}
+
+    Array(const Array &rhs, const Allocator &alloc) : Array(rhs, alloc, stats::Scope{stats::Op::copy}) {}
+
     Array &operator=(const Array &rhs) {
-        Array tmp{rhs};
-        swap(tmp);
+        constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+
+        Array tmp{rhs, propagate ? rhs.alloc_ : alloc_};
+        if constexpr (propagate)
+            std::swap(alloc_, tmp.alloc_);
+        swap_storage(tmp);
+        return *this;
+    }
+
+    Array(Array &&rhs) noexcept = default;
+
+    // Storage of rhs is taken over only if it can be deallocated by alloc
+    Array(Array &&rhs, const Allocator &alloc) : Base{0, alloc} {
+        if (alloc_ == rhs.alloc_)
+            swap_storage(rhs);
+        else
+        {
+            Array tmp(rhs.begin(), rhs.end(), alloc);
+            swap_storage(tmp);
+        }
+    }
+
+    Array &operator=(Array &&rhs)
+        noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                 alloc_traits::is_always_equal::value)
+    {
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+        {
+            std::swap(alloc_, rhs.alloc_);
+            swap_storage(rhs);
+        }
+        else
+        {
+            Array tmp{std::move(rhs), alloc_};
+            swap_storage(tmp);
+        }
         return *this;
     }
 
@@ -133,6 +251,18 @@ public:
     reverse_iterator rend() noexcept { return reverse_iterator{end()}; }
     const_iterator rend() const noexcept { return reverse_iterator{end()}; }
     const_iterator crend() const noexcept { rend(); }
+
+private:
+
+    // The scope of the copy covers the allocation too
+    Array(const Array &rhs, const Allocator &alloc, const stats::Scope &) : Base{rhs.capacity_, alloc}
+    {
+        stats::Phase_Timer timer{stats::Phase::copy};
+        stats::add_bytes(2 * rhs.capacity_ * sizeof(T));
+
+        for (; size_ != capacity_; ++size_)
+            alloc_traits::construct(alloc_, data_ + size_, rhs.data_[size_]);
+    }
 };
 
 } // namespace yLab
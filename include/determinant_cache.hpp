@@ -0,0 +1,101 @@
+#ifndef INCLUDE_DETERMINANT_CACHE_HPP
+#define INCLUDE_DETERMINANT_CACHE_HPP
+
+#include <cstdint>
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// Opt-in memoization of Matrix::determinant(). With YLAB_DET_CACHE defined, a matrix counts
+// its modifications, and the determinant is kept until the next one, so repeated calls on
+// an unchanged matrix take O(1). Otherwise the cache is an empty member, and nothing is kept.
+#ifdef YLAB_DET_CACHE
+inline constexpr bool determinant_cache_enabled = true;
+#else
+inline constexpr bool determinant_cache_enabled = false;
+#endif
+
+template<typename T, bool Enabled = determinant_cache_enabled>
+class Determinant_Cache final
+{
+public:
+
+    std::uint64_t generation() const noexcept { return 0; }
+    void invalidate() noexcept {}
+
+    const T *find() const noexcept { return nullptr; }
+    void store(const T &) const noexcept {}
+};
+
+// The generation is bumped by every modification and never goes back, so a generation seen
+// earlier identifies the same contents of the same matrix. Copies and moves carry the value
+// over, but not the generation: the destination counts its own modifications.
+template<typename T>
+class Determinant_Cache<T, true> final
+{
+public:
+
+    Determinant_Cache() = default;
+
+    Determinant_Cache(const Determinant_Cache &rhs) noexcept { copy_value(rhs); }
+
+    // The elements of a moved-from matrix are gone
+    Determinant_Cache(Determinant_Cache &&rhs) noexcept
+    {
+        copy_value(rhs);
+        rhs.invalidate();
+    }
+
+    Determinant_Cache &operator=(const Determinant_Cache &rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            invalidate();
+            copy_value(rhs);
+        }
+        return *this;
+    }
+
+    Determinant_Cache &operator=(Determinant_Cache &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            invalidate();
+            copy_value(rhs);
+            rhs.invalidate();
+        }
+        return *this;
+    }
+
+    std::uint64_t generation() const noexcept { return generation_; }
+    void invalidate() noexcept { ++generation_; }
+
+    const T *find() const noexcept { return cached_ == generation_ ? &value_ : nullptr; }
+
+    void store(const T &value) const noexcept
+    {
+        value_ = value;
+        cached_ = generation_;
+    }
+
+private:
+
+    void copy_value(const Determinant_Cache &rhs) noexcept
+    {
+        if (const T *value = rhs.find())
+            store(*value);
+    }
+
+    std::uint64_t generation_ = 1;
+    mutable std::uint64_t cached_ = 0;  // generation the value was computed at, 0 if none
+    mutable T value_{};
+};
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_DETERMINANT_CACHE_HPP
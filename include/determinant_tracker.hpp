@@ -0,0 +1,237 @@
+#ifndef INCLUDE_DETERMINANT_TRACKER_HPP
+#define INCLUDE_DETERMINANT_TRACKER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "floating_point_comparison.hpp"
+#include "lu_kernel.hpp"
+#include "matrix.hpp"
+#include "simd.hpp"
+
+namespace yLab
+{
+
+struct Undef_Update final : public Undef_Operation
+{
+    Undef_Update() : Undef_Operation{"The update doesn't match the size of the matrix"} {};
+};
+
+namespace detail
+{
+
+// The inverse is recomputed from the matrix after that many updates by default
+inline constexpr std::size_t tracker_refactor_interval = 64;
+
+} // namespace detail
+
+// Determinant of a square matrix which changes by rank-1 updates A + u * v^T, including
+// replacements of a row or a column. The tracker keeps the matrix and its inverse.
+// By the matrix determinant lemma, det(A + u * v^T) = det(A) * (1 + v^T * A^-1 * u),
+// and Sherman-Morrison formula updates the inverse:
+//
+//     (A + u * v^T)^-1 = A^-1 - (A^-1 * u) * (v^T * A^-1) / (1 + v^T * A^-1 * u),
+//
+// so an update takes O(n^2) operations instead of O(n^3) of a new decomposition.
+//
+// Rounding errors of the inverse accumulate, so it's recomputed by LU decomposition of
+// the matrix every refactor_interval updates. It's recomputed right away if the ratio of
+// the determinants 1 + v^T * A^-1 * u is close to zero: the updated matrix is nearly
+// singular then, and the formula cancels out most of the digits. While the matrix is
+// singular it has no inverse, and every update decomposes it anew.
+template<typename T, typename Allocator = std::allocator<T>>
+class Determinant_Tracker final
+{
+    static_assert(std::is_floating_point_v<T>,
+                  "Determinant tracking requires a floating-point type");
+
+    using Size_Alloc =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>;
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using matrix_type = Matrix<T, Allocator>;
+    using allocator_type = Allocator;
+
+    explicit Determinant_Tracker(const Matrix<T, Allocator> &matrix,
+                                 size_type refactor_interval = detail::tracker_refactor_interval)
+        : matrix_{matrix, matrix.get_allocator()},
+          inverse_{matrix.n_rows(), matrix.n_cols(), value_type{}, matrix.get_allocator()},
+          refactor_interval_{std::max(refactor_interval, size_type{1})}
+    {
+        if (!matrix.is_square())
+            throw Undef_Det{};
+
+        refactor();
+    }
+
+    size_type size() const noexcept { return matrix_.n_rows(); }
+
+    allocator_type get_allocator() const noexcept { return matrix_.get_allocator(); }
+
+    // The current matrix
+    const matrix_type &matrix() const noexcept { return matrix_; }
+
+    // Updates applied since the inverse was computed from the matrix
+    size_type n_updates() const noexcept { return n_updates_; }
+
+    bool is_singular() const noexcept { return singular_; }
+
+    value_type determinant() const
+    {
+        if (yLab::cmp::are_equal(determinant_, value_type{}))
+            return value_type{};
+        return determinant_;
+    }
+
+    // A += u * v^T. Returns the new determinant.
+    value_type rank_one_update(std::span<const T> u, std::span<const T> v)
+    {
+        if (u.size() != size() || v.size() != size())
+            throw Undef_Update{};
+
+        for (size_type i = 0; i != size(); ++i)
+            detail::simd::sub_scaled(size(), row(matrix_, i), v.data(), -u[i]);
+
+        if (singular_)
+            return refactor();
+
+        // w = A^-1 * u, z^T = v^T * A^-1
+        std::vector<T> w(size()), z(size());
+        for (size_type i = 0; i != size(); ++i)
+            w[i] = dot(row(inverse_, i), u.data());
+        for (size_type i = 0; i != size(); ++i)
+            detail::simd::sub_scaled(size(), z.data(), row(inverse_, i), -v[i]);
+
+        return update(w, z, 1 + dot(v.data(), w.data()));
+    }
+
+    // Row i of A becomes the given one: u = e_i, v = new row - old row.
+    // Returns the new determinant.
+    value_type replace_row(size_type i, std::span<const T> new_row)
+    {
+        if (i >= size() || new_row.size() != size())
+            throw Undef_Update{};
+
+        std::vector<T> v(new_row.begin(), new_row.end());
+        detail::simd::sub_scaled(size(), v.data(), row(matrix_, i), T{1});
+        std::copy(new_row.begin(), new_row.end(), row(matrix_, i));
+
+        if (singular_)
+            return refactor();
+
+        // w = A^-1 * e_i is column i of the inverse
+        std::vector<T> w(size()), z(size());
+        for (size_type k = 0; k != size(); ++k)
+            w[k] = row(inverse_, k)[i];
+        for (size_type k = 0; k != size(); ++k)
+            detail::simd::sub_scaled(size(), z.data(), row(inverse_, k), -v[k]);
+
+        return update(w, z, 1 + dot(v.data(), w.data()));
+    }
+
+    // Column j of A becomes the given one: u = new column - old column, v = e_j.
+    // Returns the new determinant.
+    value_type replace_column(size_type j, std::span<const T> new_column)
+    {
+        if (j >= size() || new_column.size() != size())
+            throw Undef_Update{};
+
+        std::vector<T> u(size());
+        for (size_type k = 0; k != size(); ++k)
+        {
+            u[k] = new_column[k] - row(matrix_, k)[j];
+            row(matrix_, k)[j] = new_column[k];
+        }
+
+        if (singular_)
+            return refactor();
+
+        // z^T = e_j^T * A^-1 is row j of the inverse
+        std::vector<T> w(size());
+        for (size_type k = 0; k != size(); ++k)
+            w[k] = dot(row(inverse_, k), u.data());
+        std::vector<T> z(row(inverse_, j), row(inverse_, j) + size());
+
+        return update(w, z, 1 + w[j]);
+    }
+
+    // Recomputes the determinant and the inverse from the matrix by LU decomposition.
+    // Returns the determinant.
+    value_type refactor()
+    {
+        n_updates_ = 0;
+
+        matrix_type factors{matrix_, get_allocator()};
+        std::vector<size_type, Size_Alloc> perm(size(), Size_Alloc{get_allocator()});
+
+        const int sign = detail::lu_decompose(size(), factors.data(), factors.stride(),
+                                              perm.data());
+        determinant_ = detail::lu_determinant(size(), factors.data(), factors.stride(),
+                                              perm.data(), sign);
+        singular_ = (sign == 0);
+
+        if (!singular_)
+        {
+            // A^-1 = U^-1 * L^-1 * P: column j of the identity goes to row j of P * I
+            std::fill_n(inverse_.data(), inverse_.n_rows() * inverse_.stride(), value_type{});
+            for (size_type i = 0; i != size(); ++i)
+                row(inverse_, i)[perm[i]] = value_type{1};
+
+            detail::lu_solve(size(), factors.data(), factors.stride(), perm.data(),
+                             size(), inverse_.data(), inverse_.stride());
+        }
+
+        return determinant();
+    }
+
+private:
+
+    // A^-1 -= w * z^T / ratio, det(A) *= ratio. The relative error of the formula is about
+    // epsilon / |ratio|, so ratios below sqrt(epsilon) would lose over half of the digits.
+    value_type update(const std::vector<T> &w, const std::vector<T> &z, value_type ratio)
+    {
+        const auto ratio_threshold = std::sqrt(std::numeric_limits<value_type>::epsilon());
+        if (++n_updates_ >= refactor_interval_ || !(std::abs(ratio) >= ratio_threshold))
+            return refactor();
+
+        for (size_type i = 0; i != size(); ++i)
+            detail::simd::sub_scaled(size(), row(inverse_, i), z.data(), w[i] / ratio);
+        determinant_ *= ratio;
+
+        return determinant();
+    }
+
+    static T *row(matrix_type &matrix, size_type i) noexcept
+    {
+        return matrix.data() + i * matrix.stride();
+    }
+
+    T dot(const T *x, const T *y) const noexcept
+    {
+        T sum{};
+        for (size_type k = 0; k != size(); ++k)
+            sum += x[k] * y[k];
+        return sum;
+    }
+
+    matrix_type matrix_;
+    matrix_type inverse_;
+    value_type determinant_{};
+    size_type refactor_interval_;
+    size_type n_updates_ = 0;
+    bool singular_ = false;
+};
+
+} // namespace yLab
+
+#endif // INCLUDE_DETERMINANT_TRACKER_HPP
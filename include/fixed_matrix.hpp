@@ -0,0 +1,374 @@
+#ifndef INCLUDE_FIXED_MATRIX_HPP
+#define INCLUDE_FIXED_MATRIX_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "matrix.hpp"
+#include "matrix_expr.hpp"
+#include "matrix_view.hpp"
+
+namespace yLab
+{
+
+struct Bad_Fixed_Size final : public std::invalid_argument
+{
+    Bad_Fixed_Size()
+        : std::invalid_argument{"Sizes of the matrix differ from the sizes of the fixed-size matrix"} {};
+};
+
+// Matrix of R x C elements stored in place, without padding. Everything but conversions
+// to and from dynamic matrices is constexpr; loops have constant bounds, so small products
+// and determinants are unrolled by the compiler. Determinants up to 4 x 4 are closed-form.
+//
+// Fixed_Matrix isn't a matrix expression: arithmetic operators return fixed-size matrices,
+// and view() or to_matrix() make it an operand of operations on dynamic matrices.
+template<typename T, std::size_t R, std::size_t C>
+requires std::is_arithmetic_v<T>
+class Fixed_Matrix final
+{
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+
+    // Constructors
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    constexpr Fixed_Matrix() noexcept = default;
+
+    constexpr explicit Fixed_Matrix(const value_type &value) noexcept { data_.fill(value); }
+
+    // In constant evaluation a list of wrong sizes is a compile-time error
+    constexpr Fixed_Matrix(std::initializer_list<std::initializer_list<value_type>> il_il)
+    {
+        if (il_il.size() != R)
+            throw Il_Il_Ctor_Fail{};
+
+        for (size_type row_i = 0; const auto &internal_list : il_il)
+        {
+            if (internal_list.size() != C)
+                throw Il_Il_Ctor_Fail{};
+
+            std::copy(internal_list.begin(), internal_list.end(), begin() + row_i * C);
+            ++row_i;
+        }
+    }
+
+    // From a dynamic matrix, a view or an expression of R x C elements
+    template<Matrix_Expression E>
+    requires std::is_same_v<std::remove_const_t<expr_value_t<E>>, value_type>
+    explicit Fixed_Matrix(const E &expr)
+    {
+        if (expr.n_rows() != R || expr.n_cols() != C)
+            throw Bad_Fixed_Size{};
+
+        for (size_type i = 0; i != R; ++i)
+            for (size_type j = 0; j != C; ++j)
+                (*this)[i][j] = detail::element(expr, i, j);
+    }
+
+    static constexpr Fixed_Matrix identity_matrix() noexcept
+    {
+        Fixed_Matrix res;
+        for (size_type diag_i = 0; diag_i != std::min(R, C); ++diag_i)
+            res[diag_i][diag_i] = value_type{1};
+        return res;
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Fields and elements access
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    static constexpr size_type n_rows() noexcept { return R; }
+    static constexpr size_type n_cols() noexcept { return C; }
+    static constexpr size_type stride() noexcept { return C; }
+    static constexpr size_type size() noexcept { return R * C; }
+    static constexpr bool is_square() noexcept { return R == C; }
+
+    constexpr pointer operator[](size_type row_i) noexcept { return data() + row_i * C; }
+    constexpr const_pointer operator[](size_type row_i) const noexcept { return data() + row_i * C; }
+
+    constexpr pointer data() noexcept { return data_.data(); }
+    constexpr const_pointer data() const noexcept { return data_.data(); }
+
+    constexpr iterator begin() noexcept { return data(); }
+    constexpr const_iterator begin() const noexcept { return data(); }
+    constexpr iterator end() noexcept { return data() + size(); }
+    constexpr const_iterator end() const noexcept { return data() + size(); }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Interoperation with dynamic matrices
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    Matrix_View<value_type> view() noexcept { return {data(), R, C, C}; }
+    Const_Matrix_View<value_type> view() const noexcept { return {data(), R, C, C}; }
+
+    template<typename Allocator = std::allocator<value_type>>
+    Matrix<value_type, Allocator> to_matrix(const Allocator &alloc = Allocator{}) const
+    {
+        return Matrix<value_type, Allocator>(view(), alloc);
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Some convenient methods
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    constexpr Fixed_Matrix<value_type, C, R> transposed() const noexcept
+    {
+        Fixed_Matrix<value_type, C, R> res;
+        for (size_type i = 0; i != R; ++i)
+            for (size_type j = 0; j != C; ++j)
+                res[j][i] = (*this)[i][j];
+        return res;
+    }
+
+    // Closed-form up to 4 x 4. Larger matrices are eliminated in a copy: integral ones
+    // by Bareiss algorithm, floating point ones by Gauss algorithm with partial pivoting.
+    constexpr value_type determinant() const noexcept requires (R == C)
+    {
+        const auto &a = *this;
+
+        if constexpr (R == 0)
+            return value_type{1};
+        else if constexpr (R == 1)
+            return a[0][0];
+        else if constexpr (R == 2)
+            return a[0][0] * a[1][1] - a[0][1] * a[1][0];
+        else if constexpr (R == 3)
+            return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+                   a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+                   a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+        else if constexpr (R == 4)
+        {
+            // Laplace expansion by the 2 x 2 minors of the upper and the lower halves
+            const value_type s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+            const value_type s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+            const value_type s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+            const value_type s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+            const value_type s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+            const value_type s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+            const value_type c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+            const value_type c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+            const value_type c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+            const value_type c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+            const value_type c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+            const value_type c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+        else
+        {
+            Fixed_Matrix copy = *this;
+            return copy.det_algorithm();
+        }
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Arithmetic operators
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    constexpr Fixed_Matrix &operator+=(const Fixed_Matrix &rhs) noexcept
+    {
+        for (size_type i = 0; i != size(); ++i)
+            data_[i] += rhs.data_[i];
+        return *this;
+    }
+
+    constexpr Fixed_Matrix &operator-=(const Fixed_Matrix &rhs) noexcept
+    {
+        for (size_type i = 0; i != size(); ++i)
+            data_[i] -= rhs.data_[i];
+        return *this;
+    }
+
+    constexpr Fixed_Matrix &operator*=(const value_type &value) noexcept
+    {
+        for (auto &elem : data_)
+            elem *= value;
+        return *this;
+    }
+
+    constexpr Fixed_Matrix &operator/=(const value_type &value) noexcept
+    {
+        for (auto &elem : data_)
+            elem /= value;
+        return *this;
+    }
+
+    friend constexpr bool operator==(const Fixed_Matrix &lhs, const Fixed_Matrix &rhs) noexcept
+    {
+        return lhs.data_ == rhs.data_;
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+private:
+
+    static constexpr value_type abs(value_type value) noexcept
+    {
+        return value < value_type{} ? -value : value;
+    }
+
+    constexpr void swap_rows(size_type first, size_type second) noexcept
+    {
+        for (size_type j = 0; j != C; ++j)
+            std::swap((*this)[first][j], (*this)[second][j]);
+    }
+
+    constexpr size_type find_pivot(size_type col) const noexcept
+    {
+        size_type pivot = col;
+        for (size_type row_i = col + 1; row_i != R; ++row_i)
+            if (abs((*this)[pivot][col]) < abs((*this)[row_i][col]))
+                pivot = row_i;
+        return pivot;
+    }
+
+    // Gauss algorithm
+    constexpr value_type det_algorithm() noexcept requires std::is_floating_point_v<value_type>
+    {
+        value_type determinant{1};
+
+        for (size_type k = 0; k != R; ++k)
+        {
+            const auto pivot_pos = find_pivot(k);
+            if ((*this)[pivot_pos][k] == value_type{})
+                return value_type{};
+
+            if (pivot_pos != k)
+            {
+                swap_rows(k, pivot_pos);
+                determinant = -determinant;
+            }
+
+            const value_type pivot = (*this)[k][k];
+            determinant *= pivot;
+
+            for (size_type i = k + 1; i != R; ++i)
+            {
+                const value_type factor = (*this)[i][k] / pivot;
+                for (size_type j = k + 1; j != C; ++j)
+                    (*this)[i][j] -= factor * (*this)[k][j];
+            }
+        }
+
+        return determinant;
+    }
+
+    // Bareiss algorithm
+    constexpr value_type det_algorithm() noexcept requires std::is_integral_v<value_type>
+    {
+        bool negate = false;
+        value_type init_val{1};
+
+        for (size_type k = 0; k != R - 1; ++k)
+        {
+            const auto pivot_pos = find_pivot(k);
+            if ((*this)[pivot_pos][k] == value_type{})
+                return value_type{};
+
+            if (pivot_pos != k)
+            {
+                swap_rows(k, pivot_pos);
+                negate = !negate;
+            }
+
+            const value_type pivot = (*this)[k][k];
+            for (size_type i = k + 1; i != R; ++i)
+            {
+                for (size_type j = k + 1; j != C; ++j)
+                    (*this)[i][j] = (pivot * (*this)[i][j] - (*this)[i][k] * (*this)[k][j]) / init_val;
+                (*this)[i][k] = value_type{};
+            }
+
+            init_val = pivot;
+        }
+
+        const value_type determinant = (*this)[R - 1][C - 1];
+        return negate ? -determinant : determinant;
+    }
+
+    std::array<value_type, R * C> data_{};
+};
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Fixed_Matrix<T, R, C> operator+(Fixed_Matrix<T, R, C> lhs,
+                                          const Fixed_Matrix<T, R, C> &rhs) noexcept
+{
+    return lhs += rhs;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Fixed_Matrix<T, R, C> operator-(Fixed_Matrix<T, R, C> lhs,
+                                          const Fixed_Matrix<T, R, C> &rhs) noexcept
+{
+    return lhs -= rhs;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Fixed_Matrix<T, R, C> operator*(Fixed_Matrix<T, R, C> lhs, const T &value) noexcept
+{
+    return lhs *= value;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Fixed_Matrix<T, R, C> operator*(const T &value, Fixed_Matrix<T, R, C> rhs) noexcept
+{
+    return rhs *= value;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr Fixed_Matrix<T, R, C> operator/(Fixed_Matrix<T, R, C> lhs, const T &value) noexcept
+{
+    return lhs /= value;
+}
+
+// Every element of the product is a fold over index sequences, so the whole product
+// is unrolled for any sizes
+template<typename T, std::size_t M, std::size_t K, std::size_t N>
+constexpr Fixed_Matrix<T, M, N> product(const Fixed_Matrix<T, M, K> &lhs,
+                                        const Fixed_Matrix<T, K, N> &rhs) noexcept
+{
+    Fixed_Matrix<T, M, N> result;
+
+    [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        auto dot = [&]<std::size_t... Ks>(std::size_t i, std::size_t j, std::index_sequence<Ks...>)
+        {
+            return static_cast<T>((T{} + ... + (lhs[i][Ks] * rhs[Ks][j])));
+        };
+
+        ((result[Is / N][Is % N] = dot(Is / N, Is % N, std::make_index_sequence<K>{})), ...);
+    }(std::make_index_sequence<M * N>{});
+
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+std::ostream &operator<<(std::ostream &os, const Fixed_Matrix<T, R, C> &matrix)
+{
+    return os << matrix.view();
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_FIXED_MATRIX_HPP
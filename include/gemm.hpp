@@ -0,0 +1,281 @@
+#ifndef INCLUDE_GEMM_HPP
+#define INCLUDE_GEMM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// Blocking parameters of the packed GEMM (Goto's algorithm):
+//   MR x NR - register tile kept in the micro-kernel accumulators;
+//   KC      - depth of packed panels (a KC x NR sliver of B stays in L1);
+//   MC      - height of a packed block of A (MC x KC resides in L2);
+//   NC      - width of a packed block of B (KC x NC resides in L3).
+template<typename T>
+struct Gemm_Blocking final
+{
+    static constexpr std::size_t NR = std::max<std::size_t>(64 / sizeof(T), 4);
+    static constexpr std::size_t MR = 4;
+    static constexpr std::size_t KC = 256;
+    static constexpr std::size_t MC = 128;
+    static constexpr std::size_t NC = 4096;
+};
+
+// Products with fewer multiply-adds than that don't amortize packing
+inline constexpr std::size_t gemm_small_threshold = 32 * 32 * 32;
+
+// Operands are addressed by a row stride and a column stride: element (i, j) of A
+// is a[i * a_rs + j * a_cs]. So transposed and other strided views are multiplied
+// without copying, as packing reorders elements anyway.
+
+// Packs rows [0, mc) x columns [0, kc) of A into MR-row slivers stored k-major.
+// The last sliver is padded with zeros up to MR rows.
+template<typename T>
+void pack_a(std::size_t mc, std::size_t kc, const T *a, std::size_t a_rs, std::size_t a_cs,
+            T *packed)
+{
+    constexpr auto MR = Gemm_Blocking<T>::MR;
+
+    for (std::size_t i = 0; i < mc; i += MR)
+    {
+        const auto mr = std::min(MR, mc - i);
+        for (std::size_t p = 0; p != kc; ++p)
+        {
+            std::size_t ii = 0;
+            for (; ii != mr; ++ii)
+                packed[ii] = a[(i + ii) * a_rs + p * a_cs];
+            for (; ii != MR; ++ii)
+                packed[ii] = T{};
+            packed += MR;
+        }
+    }
+}
+
+// Packs rows [0, kc) x columns [0, nc) of B into NR-column slivers stored k-major.
+// The last sliver is padded with zeros up to NR columns.
+template<typename T>
+void pack_b(std::size_t kc, std::size_t nc, const T *b, std::size_t b_rs, std::size_t b_cs,
+            T *packed)
+{
+    constexpr auto NR = Gemm_Blocking<T>::NR;
+
+    for (std::size_t j = 0; j < nc; j += NR)
+    {
+        const auto nr = std::min(NR, nc - j);
+        for (std::size_t p = 0; p != kc; ++p)
+        {
+            const T *b_row = b + p * b_rs + j * b_cs;
+            std::size_t jj = 0;
+            if (b_cs == 1)
+                for (; jj != nr; ++jj)
+                    packed[jj] = b_row[jj];
+            else
+                for (; jj != nr; ++jj)
+                    packed[jj] = b_row[jj * b_cs];
+            for (; jj != NR; ++jj)
+                packed[jj] = T{};
+            packed += NR;
+        }
+    }
+}
+
+// C[0:mr, 0:nr] += alpha * A_sliver * B_sliver
+template<typename T>
+void micro_kernel(std::size_t kc, const T *__restrict a, const T *__restrict b,
+                  T *c, std::size_t ldc, std::size_t mr, std::size_t nr, T alpha)
+{
+    constexpr auto MR = Gemm_Blocking<T>::MR;
+    constexpr auto NR = Gemm_Blocking<T>::NR;
+
+    T acc[MR][NR]{};
+
+    for (std::size_t p = 0; p != kc; ++p, a += MR, b += NR)
+        for (std::size_t i = 0; i != MR; ++i)
+        {
+            const T a_i = a[i];
+            for (std::size_t j = 0; j != NR; ++j)
+                acc[i][j] += a_i * b[j];
+        }
+
+    if (mr == MR && nr == NR)
+    {
+        for (std::size_t i = 0; i != MR; ++i)
+            for (std::size_t j = 0; j != NR; ++j)
+                c[i * ldc + j] += alpha * acc[i][j];
+    }
+    else
+    {
+        for (std::size_t i = 0; i != mr; ++i)
+            for (std::size_t j = 0; j != nr; ++j)
+                c[i * ldc + j] += alpha * acc[i][j];
+    }
+}
+
+// C += alpha * A * B for small operands: i-k-j order streams rows of B and C
+template<typename T>
+void gemm_small(std::size_t m, std::size_t n, std::size_t k,
+                const T *a, std::size_t a_rs, std::size_t a_cs,
+                const T *b, std::size_t b_rs, std::size_t b_cs,
+                T *c, std::size_t ldc, T alpha)
+{
+    for (std::size_t i = 0; i != m; ++i)
+    {
+        T *c_row = c + i * ldc;
+        for (std::size_t p = 0; p != k; ++p)
+        {
+            const T a_ip = alpha * a[i * a_rs + p * a_cs];
+            const T *b_row = b + p * b_rs;
+            if (b_cs == 1)
+                for (std::size_t j = 0; j != n; ++j)
+                    c_row[j] += a_ip * b_row[j];
+            else
+                for (std::size_t j = 0; j != n; ++j)
+                    c_row[j] += a_ip * b_row[j * b_cs];
+        }
+    }
+}
+
+// C += alpha * A * B, where A is m x k, B is k x n and C is m x n. A and B are strided,
+// C is row-major with leading dimension ldc.
+template<typename T>
+requires std::is_arithmetic_v<T>
+void gemm_strided(std::size_t m, std::size_t n, std::size_t k,
+                  const T *a, std::size_t a_rs, std::size_t a_cs,
+                  const T *b, std::size_t b_rs, std::size_t b_cs,
+                  T *c, std::size_t ldc, T alpha = T{1})
+{
+    if (m == 0 || n == 0 || k == 0)
+        return;
+
+    if (m * n * k <= gemm_small_threshold)
+    {
+        gemm_small(m, n, k, a, a_rs, a_cs, b, b_rs, b_cs, c, ldc, alpha);
+        return;
+    }
+
+    using Blocking = Gemm_Blocking<T>;
+    constexpr auto MR = Blocking::MR;
+    constexpr auto NR = Blocking::NR;
+
+    const auto kc_max = std::min(Blocking::KC, k);
+    const auto mc_max = std::min(Blocking::MC, (m + MR - 1) / MR * MR);
+    const auto nc_max = std::min(Blocking::NC, (n + NR - 1) / NR * NR);
+
+    // Packing buffers only grow and are reused by later calls in the same thread,
+    // so repeated products don't hit the heap
+    thread_local std::vector<T> packed_a;
+    thread_local std::vector<T> packed_b;
+    if (packed_a.size() < mc_max * kc_max)
+        packed_a.resize(mc_max * kc_max);
+    if (packed_b.size() < kc_max * nc_max)
+        packed_b.resize(kc_max * nc_max);
+
+    for (std::size_t jc = 0; jc < n; jc += Blocking::NC)
+    {
+        const auto nc = std::min(Blocking::NC, n - jc);
+
+        for (std::size_t pc = 0; pc < k; pc += Blocking::KC)
+        {
+            const auto kc = std::min(Blocking::KC, k - pc);
+            pack_b(kc, nc, b + pc * b_rs + jc * b_cs, b_rs, b_cs, packed_b.data());
+
+            for (std::size_t ic = 0; ic < m; ic += Blocking::MC)
+            {
+                const auto mc = std::min(Blocking::MC, m - ic);
+                pack_a(mc, kc, a + ic * a_rs + pc * a_cs, a_rs, a_cs, packed_a.data());
+
+                for (std::size_t jr = 0; jr < nc; jr += NR)
+                {
+                    const auto nr = std::min(NR, nc - jr);
+                    const T *b_sliver = packed_b.data() + jr * kc;
+
+                    for (std::size_t ir = 0; ir < mc; ir += MR)
+                    {
+                        const auto mr = std::min(MR, mc - ir);
+                        micro_kernel(kc, packed_a.data() + ir * kc, b_sliver,
+                                     c + (ic + ir) * ldc + jc + jr, ldc, mr, nr, alpha);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// C += alpha * A * B, where A is m x k, B is k x n, C is m x n; all row-major
+// with leading dimensions lda, ldb and ldc respectively
+template<typename T>
+requires std::is_arithmetic_v<T>
+void gemm(std::size_t m, std::size_t n, std::size_t k,
+          const T *a, std::size_t lda, const T *b, std::size_t ldb,
+          T *c, std::size_t ldc, T alpha = T{1})
+{
+    gemm_strided(m, n, k, a, lda, std::size_t{1}, b, ldb, std::size_t{1}, c, ldc, alpha);
+}
+
+// Parallel C += A * B: the output is cut into a grid of tiles of whole register
+// blocks, and each tile is computed by an independent sequential gemm
+template<typename T>
+requires std::is_arithmetic_v<T>
+void parallel_gemm_strided(Thread_Pool &pool, std::size_t m, std::size_t n, std::size_t k,
+                           const T *a, std::size_t a_rs, std::size_t a_cs,
+                           const T *b, std::size_t b_rs, std::size_t b_cs,
+                           T *c, std::size_t ldc)
+{
+    using Blocking = Gemm_Blocking<T>;
+    constexpr auto MR = Blocking::MR;
+    constexpr auto NR = Blocking::NR;
+
+    if (pool.n_threads() == 1 || m * n * k <= gemm_small_threshold)
+    {
+        gemm_strided(m, n, k, a, a_rs, a_cs, b, b_rs, b_cs, c, ldc);
+        return;
+    }
+
+    // A couple of tiles per thread smooths out the imbalance between them
+    const std::size_t target_n_tiles = 2 * pool.n_threads();
+
+    const auto n_row_blocks = (m + MR - 1) / MR;
+    const auto n_col_blocks = (n + NR - 1) / NR;
+
+    const auto n_row_tiles = std::min(n_row_blocks, target_n_tiles);
+    const auto n_col_tiles = std::min(n_col_blocks,
+                                      (target_n_tiles + n_row_tiles - 1) / n_row_tiles);
+
+    const auto tile_height = (n_row_blocks + n_row_tiles - 1) / n_row_tiles * MR;
+    const auto tile_width = (n_col_blocks + n_col_tiles - 1) / n_col_tiles * NR;
+
+    pool.parallel_for(n_row_tiles * n_col_tiles, [&](std::size_t tile_i)
+    {
+        const auto row = tile_i / n_col_tiles * tile_height;
+        const auto col = tile_i % n_col_tiles * tile_width;
+        if (row >= m || col >= n)
+            return;
+
+        gemm_strided(std::min(tile_height, m - row), std::min(tile_width, n - col), k,
+                     a + row * a_rs, a_rs, a_cs, b + col * b_cs, b_rs, b_cs,
+                     c + row * ldc + col, ldc);
+    });
+}
+
+template<typename T>
+requires std::is_arithmetic_v<T>
+void parallel_gemm(Thread_Pool &pool, std::size_t m, std::size_t n, std::size_t k,
+                   const T *a, std::size_t lda, const T *b, std::size_t ldb,
+                   T *c, std::size_t ldc)
+{
+    parallel_gemm_strided(pool, m, n, k, a, lda, std::size_t{1}, b, ldb, std::size_t{1}, c, ldc);
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_GEMM_HPP
@@ -0,0 +1,141 @@
+#ifndef INCLUDE_LU_HPP
+#define INCLUDE_LU_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "floating_point_comparison.hpp"
+#include "lu_kernel.hpp"
+#include "matrix.hpp"
+
+namespace yLab
+{
+
+struct Undef_LU final : public Undef_Operation
+{
+    Undef_LU() : Undef_Operation{"LU decomposition is not defined for non-square matrices"} {};
+};
+
+struct Singular_Matrix final : public Undef_Operation
+{
+    Singular_Matrix() : Undef_Operation{"The matrix is singular"} {};
+};
+
+struct Undef_Solve final : public Undef_Operation
+{
+    Undef_Solve()
+        : Undef_Operation{"The number of rows of the right-hand side must match the matrix size"} {};
+};
+
+// LU decomposition with partial pivoting: P * A = L * U.
+// The decomposition costs O(n^3) once; then determinant() is O(n) and solve() is O(n^2)
+// per right-hand side.
+template<typename T, typename Allocator>
+class LU final
+{
+    static_assert(std::is_floating_point_v<T>, "LU decomposition requires a floating-point type");
+
+    using Size_Alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>;
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using matrix_type = Matrix<T, Allocator>;
+    using allocator_type = Allocator;
+
+    // The factors and the results of solve() use the allocator of the matrix
+    explicit LU(const matrix_type &matrix)
+        : factors_{matrix, matrix.get_allocator()},
+          perm_(matrix.n_rows(), Size_Alloc{matrix.get_allocator()})
+    {
+        if (!matrix.is_square())
+            throw Undef_LU{};
+
+        sign_ = detail::lu_decompose(size(), factors_.data(), factors_.stride(), perm_.data());
+    }
+
+    size_type size() const noexcept { return factors_.n_rows(); }
+
+    bool is_singular() const noexcept { return sign_ == 0; }
+
+    // Row i of P * A is row permutation()[i] of A
+    const std::vector<size_type, Size_Alloc> &permutation() const noexcept { return perm_; }
+
+    allocator_type get_allocator() const noexcept { return factors_.get_allocator(); }
+
+    value_type determinant() const
+    {
+        const value_type determinant =
+            detail::lu_determinant(size(), factors_.data(), factors_.stride(), perm_.data(), sign_);
+
+        if (yLab::cmp::are_equal(determinant, value_type{}))
+            return value_type{};
+        return determinant;
+    }
+
+    // Solves A * X = B for every column of B
+    matrix_type solve(const matrix_type &rhs) const
+    {
+        if (rhs.n_rows() != size())
+            throw Undef_Solve{};
+        if (is_singular())
+            throw Singular_Matrix{};
+
+        const auto n_rhs = rhs.n_cols();
+        matrix_type solution{size(), n_rhs, T{}, get_allocator()};
+
+        for (size_type i = 0; i != size(); ++i)
+            std::copy_n(rhs.data() + perm_[i] * rhs.stride(), n_rhs,
+                        solution.data() + i * solution.stride());
+
+        detail::lu_solve(size(), factors_.data(), factors_.stride(), perm_.data(),
+                         n_rhs, solution.data(), solution.stride());
+
+        return solution;
+    }
+
+    // Solves A * x = b
+    std::vector<T> solve(const std::vector<T> &rhs) const
+    {
+        if (rhs.size() != size())
+            throw Undef_Solve{};
+        if (is_singular())
+            throw Singular_Matrix{};
+
+        std::vector<T> solution(size());
+        for (size_type i = 0; i != size(); ++i)
+            solution[i] = rhs[perm_[i]];
+
+        detail::lu_solve(size(), factors_.data(), factors_.stride(), perm_.data(),
+                         1, solution.data(), 1);
+
+        return solution;
+    }
+
+    matrix_type inverse() const
+    {
+        return solve(matrix_type::identity_matrix(size(), size(), get_allocator()));
+    }
+
+private:
+
+    matrix_type factors_;
+    std::vector<size_type, Size_Alloc> perm_;
+    int sign_;
+};
+
+template<typename T, typename Allocator>
+requires std::is_arithmetic_v<T>
+LU<T, Allocator> Matrix<T, Allocator>::lu() const requires std::is_floating_point_v<T>
+{
+    return LU<T, Allocator>{*this};
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_LU_HPP
@@ -0,0 +1,144 @@
+#ifndef INCLUDE_LU_KERNEL_HPP
+#define INCLUDE_LU_KERNEL_HPP
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+
+#include "simd.hpp"
+#include "stats.hpp"
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// In-place LU decomposition with partial pivoting of an n x n row-major matrix.
+//
+// Rows are never moved: logical row i of the factors is stored in physical row perm[i].
+// On return, the strictly lower part of the logical matrix holds unit lower-triangular L
+// and the rest holds U, so that A[perm[i]][j] == (L * U)[i][j].
+//
+// Returns the sign of the permutation, or 0 if the matrix is singular.
+template<std::floating_point T>
+int lu_decompose(std::size_t n, T *a, std::size_t lda, std::size_t *perm)
+{
+    std::iota(perm, perm + n, std::size_t{0});
+
+    int sign = 1;
+    bool is_singular = false;
+
+    for (std::size_t k = 0; k != n; ++k)
+    {
+        std::size_t pivot_i = k;
+        T pivot_abs = std::abs(a[perm[k] * lda + k]);
+
+        {
+            stats::Phase_Timer timer{stats::Phase::pivot_search};
+            for (std::size_t i = k + 1; i != n; ++i)
+            {
+                const T elem_abs = std::abs(a[perm[i] * lda + k]);
+                if (pivot_abs < elem_abs)
+                {
+                    pivot_i = i;
+                    pivot_abs = elem_abs;
+                }
+            }
+        }
+
+        // The whole column below the diagonal is zero, so multipliers are zeros as well
+        if (pivot_abs == T{})
+        {
+            is_singular = true;
+            continue;
+        }
+
+        if (pivot_i != k)
+        {
+            stats::Phase_Timer timer{stats::Phase::row_swap};
+            stats::add_pivot_swaps();
+            std::swap(perm[k], perm[pivot_i]);
+            sign = -sign;
+        }
+
+        stats::Phase_Timer timer{stats::Phase::elimination};
+        const T *pivot_row = a + perm[k] * lda;
+        const T pivot = pivot_row[k];
+
+        for (std::size_t i = k + 1; i != n; ++i)
+        {
+            T *row = a + perm[i] * lda;
+            const T coeff = row[k] / pivot;
+            row[k] = coeff;
+
+            simd::sub_scaled(n - k - 1, row + k + 1, pivot_row + k + 1, coeff);
+        }
+    }
+
+    return is_singular ? 0 : sign;
+}
+
+// Determinant of a matrix decomposed by lu_decompose()
+template<std::floating_point T>
+T lu_determinant(std::size_t n, const T *a, std::size_t lda, const std::size_t *perm, int sign)
+{
+    if (sign == 0)
+        return T{};
+
+    T determinant{1};
+    for (std::size_t i = 0; i != n; ++i)
+        determinant *= a[perm[i] * lda + i];
+
+    return (sign < 0) ? -determinant : determinant;
+}
+
+// Solves L * U * X = B in place for n_rhs right-hand sides. On entry x holds P * B,
+// i.e. its logical row i is row perm[i] of B; on exit it holds X.
+// Takes O(n^2) operations per right-hand side.
+template<std::floating_point T>
+void lu_solve(std::size_t n, const T *a, std::size_t lda, const std::size_t *perm,
+              std::size_t n_rhs, T *x, std::size_t ldx)
+{
+    // Forward substitution with unit lower-triangular L
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        const T *l_row = a + perm[i] * lda;
+        T *x_i = x + i * ldx;
+
+        for (std::size_t k = 0; k != i; ++k)
+        {
+            const T l_ik = l_row[k];
+            const T *x_k = x + k * ldx;
+            for (std::size_t j = 0; j != n_rhs; ++j)
+                x_i[j] -= l_ik * x_k[j];
+        }
+    }
+
+    // Back substitution with U
+    for (std::size_t i = n; i-- != 0;)
+    {
+        const T *u_row = a + perm[i] * lda;
+        T *x_i = x + i * ldx;
+
+        for (std::size_t k = i + 1; k != n; ++k)
+        {
+            const T u_ik = u_row[k];
+            const T *x_k = x + k * ldx;
+            for (std::size_t j = 0; j != n_rhs; ++j)
+                x_i[j] -= u_ik * x_k[j];
+        }
+
+        const T u_ii = u_row[i];
+        for (std::size_t j = 0; j != n_rhs; ++j)
+            x_i[j] /= u_ii;
+    }
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_LU_KERNEL_HPP
@@ -4,17 +4,36 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <iomanip>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <ostream>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
 
+#include "cholesky_kernel.hpp"
 #include "container.hpp"
+#include "determinant_cache.hpp"
 #include "floating_point_comparison.hpp"
+#include "gemm.hpp"
+#include "lu_kernel.hpp"
+#include "matrix_expr.hpp"
+#include "matrix_view.hpp"
+#include "simd.hpp"
+#include "stats.hpp"
+#include "strassen.hpp"
+#include "structure.hpp"
+#include "thread_pool.hpp"
+#include "tiled_lu.hpp"
+#include "transpose.hpp"
 
 namespace yLab
 {
@@ -50,9 +69,36 @@ struct Il_Il_Ctor_Fail final : public std::runtime_error
         : std::runtime_error{"The number of elements in each row must be the same"} {}
 };
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>>
+class LU;
+
+template<typename T, typename Allocator = std::allocator<T>>
+class Cholesky;
+
+template<typename T, typename Allocator = std::allocator<T>>
+class Mixed_LU;
+
+namespace detail
+{
+
+// Rows are padded to a multiple of the alignment guaranteed by the allocator, if any
+template<typename T, typename Allocator>
+constexpr std::size_t row_stride(std::size_t n_cols) noexcept
+{
+    if constexpr (requires { Allocator::alignment; })
+    {
+        constexpr std::size_t elems_per_line = std::max<std::size_t>(Allocator::alignment / sizeof(T), 1);
+        return (n_cols + elems_per_line - 1) / elems_per_line * elems_per_line;
+    }
+    else
+        return n_cols;
+}
+
+} // namespace detail
+
+template<typename T, typename Allocator = std::allocator<T>>
 requires std::is_arithmetic_v<T>
-class Matrix final : private Array<T>
+class Matrix final : private Array<T, Allocator>
 {
     template<typename Ptr_T>
     struct Proxy_Row final
@@ -63,38 +109,49 @@ class Matrix final : private Array<T>
         Data_T &operator[](std::size_t j) const { return row_[j]; }
     };
 
+    // Views compute their determinants in a copy of their own (see scratch_determinant())
+    template<typename U>
+    requires std::is_arithmetic_v<U>
+    friend class Matrix_View;
+
 public:
 
-    using typename Array<T>::value_type;
-    using typename Array<T>::reference;
-    using typename Array<T>::const_reference;
-    using typename Array<T>::pointer;
-    using typename Array<T>::const_pointer;
-    using typename Array<T>::size_type;
-    using typename Array<T>::iterator;
-    using typename Array<T>::const_iterator;
-    using typename Array<T>::reverse_iterator;
-    using typename Array<T>::const_reverse_iterator;
-
-    using Array<T>::begin;
-    using Array<T>::end;
-    using Array<T>::cbegin;
-    using Array<T>::cend;
-    using Array<T>::rbegin;
-    using Array<T>::rend;
-    using Array<T>::crbegin;
-    using Array<T>::crend;
-    using Array<T>::data;
-    using Array<T>::size;
+    using typename Array<T, Allocator>::value_type;
+    using typename Array<T, Allocator>::allocator_type;
+    using typename Array<T, Allocator>::reference;
+    using typename Array<T, Allocator>::const_reference;
+    using typename Array<T, Allocator>::pointer;
+    using typename Array<T, Allocator>::const_pointer;
+    using typename Array<T, Allocator>::size_type;
+    using typename Array<T, Allocator>::iterator;
+    using typename Array<T, Allocator>::const_iterator;
+    using typename Array<T, Allocator>::reverse_iterator;
+    using typename Array<T, Allocator>::const_reverse_iterator;
+
+    using Array<T, Allocator>::begin;
+    using Array<T, Allocator>::end;
+    using Array<T, Allocator>::cbegin;
+    using Array<T, Allocator>::cend;
+    using Array<T, Allocator>::rbegin;
+    using Array<T, Allocator>::rend;
+    using Array<T, Allocator>::crbegin;
+    using Array<T, Allocator>::crend;
+    using Array<T, Allocator>::data;
+    using Array<T, Allocator>::size;
+    using Array<T, Allocator>::get_allocator;
 
     // Constructors
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    Matrix(size_type n_rows, size_type n_cols, value_type value = value_type{})
-        : Array<T>(n_rows * n_cols, value), n_rows_{n_rows}, n_cols_{n_cols} {}
+    Matrix(size_type n_rows, size_type n_cols, value_type value = value_type{},
+           const allocator_type &alloc = allocator_type{})
+        : Array<T, Allocator>(n_rows * detail::row_stride<T, Allocator>(n_cols), value, alloc),
+          n_rows_{n_rows}, n_cols_{n_cols} {}
 
-    Matrix(std::initializer_list<std::initializer_list<value_type>> il_il)
-        : Array<T>(il_il.size() * il_il.begin()->size()),
+    Matrix(std::initializer_list<std::initializer_list<value_type>> il_il,
+           const allocator_type &alloc = allocator_type{})
+        : Array<T, Allocator>(il_il.size() * detail::row_stride<T, Allocator>(il_il.begin()->size()),
+                              alloc),
           n_rows_{il_il.size()}, n_cols_{il_il.begin()->size()}
     {
         for (size_type row_i = 0; const auto &internal_list : il_il)
@@ -102,26 +159,51 @@ public:
             if (internal_list.size() != n_cols_)
                 throw Il_Il_Ctor_Fail{};
 
-            std::copy(internal_list.begin(), internal_list.end(), begin() + row_i * n_cols_);
+            std::copy(internal_list.begin(), internal_list.end(), begin() + row_i * stride());
             ++row_i;
         }
     }
 
     template<std::input_iterator Iter>
-    Matrix(size_type n_rows, size_type n_cols, Iter begin, Iter end)
-        : Array<T>(n_rows * n_cols), n_rows_{n_rows}, n_cols_{n_cols}
+    Matrix(size_type n_rows, size_type n_cols, Iter begin, Iter end,
+           const allocator_type &alloc = allocator_type{})
+        : Array<T, Allocator>(n_rows * detail::row_stride<T, Allocator>(n_cols), alloc),
+          n_rows_{n_rows}, n_cols_{n_cols}
     {
-        size_type i = 0;
-        for (auto iter = begin; iter != end && i != size(); ++iter, ++i)
-            data()[i] = *iter;
-
-        for (; i != size(); ++i)
-            data()[i] = value_type{};
+        auto iter = begin;
+        for (size_type i = 0; i != n_rows_ && iter != end; ++i)
+            for (size_type j = 0; j != n_cols_ && iter != end; ++j, ++iter)
+                (*this)[i][j] = *iter;
     }
 
-    static Matrix identity_matrix(size_type n_rows, size_type n_cols)
+    // Copies are made with the given allocator, unlike the copy constructor, which asks
+    // the allocator of rhs (std::pmr::polymorphic_allocator falls back to the default resource)
+    Matrix(const Matrix &rhs, const allocator_type &alloc)
+        : Array<T, Allocator>(rhs, alloc), n_rows_{rhs.n_rows_}, n_cols_{rhs.n_cols_},
+          det_cache_{rhs.det_cache_} {}
+
+    Matrix(Matrix &&rhs, const allocator_type &alloc)
+        : Array<T, Allocator>(std::move(rhs), alloc),
+          n_rows_{std::exchange(rhs.n_rows_, 0)}, n_cols_{std::exchange(rhs.n_cols_, 0)},
+          det_cache_{std::move(rhs.det_cache_)} {}
+
+    // Evaluates an expression in a single pass. If the expression owns an rvalue operand,
+    // the result is computed in place in its storage, so nothing is allocated at all.
+    // Without an allocator the result keeps the allocator of that operand.
+    template<Matrix_Expression E>
+    requires (!std::is_same_v<std::remove_cvref_t<E>, Matrix> &&
+              std::is_same_v<expr_value_t<E>, value_type>)
+    Matrix(E &&expr) : Matrix(evaluate(std::forward<E>(expr), nullptr)) {}
+
+    template<Matrix_Expression E>
+    requires (!std::is_same_v<std::remove_cvref_t<E>, Matrix> &&
+              std::is_same_v<expr_value_t<E>, value_type>)
+    Matrix(E &&expr, const allocator_type &alloc) : Matrix(evaluate(std::forward<E>(expr), &alloc)) {}
+
+    static Matrix identity_matrix(size_type n_rows, size_type n_cols,
+                                  const allocator_type &alloc = allocator_type{})
     {
-        Matrix res{n_rows, n_cols};
+        Matrix res{n_rows, n_cols, value_type{}, alloc};
         const size_type min_size = std::min(n_rows, n_cols);
         for (size_type diag_i = 0; diag_i != min_size; ++diag_i)
             res[diag_i][diag_i] = value_type{1};
@@ -136,6 +218,19 @@ public:
     size_type n_cols() const noexcept { return n_cols_; }
     size_type n_rows() const noexcept { return n_rows_; }
 
+    // Distance between the beginnings of adjacent rows. It's greater than n_cols() when the
+    // allocator guarantees alignment (see Aligned_Allocator): then every row is aligned too.
+    // Values of the padding elements are unspecified; begin(), end() and size() cover them.
+    size_type stride() const noexcept { return detail::row_stride<T, Allocator>(n_cols_); }
+
+    // Number of the current state of the elements (see determinant()). It grows whenever
+    // the matrix is modified or hands out mutable access to its elements. Always 0 unless
+    // the project is configured with -DYLAB_DET_CACHE=ON.
+    std::uint64_t generation() const noexcept
+    {
+        return det_cache_.generation();
+    }
+
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
     // Elements access
@@ -143,14 +238,80 @@ public:
 
     Proxy_Row<const value_type *> operator[](size_type row_i) const
     {
-        return Proxy_Row{data() + row_i * n_cols_};
+        return Proxy_Row{data() + row_i * stride()};
     }
 
     Proxy_Row<value_type *> operator[](size_type row_i)
     {
-        return Proxy_Row{data() + row_i * n_cols_};
+        return Proxy_Row{data() + row_i * stride()};
+    }
+
+    // Mutable access to the elements counts as a modification of the matrix. Everything else
+    // which writes to it, including views, goes through these.
+    pointer data() noexcept
+    {
+        det_cache_.invalidate();
+        return Array<T, Allocator>::data();
+    }
+
+    iterator begin() noexcept
+    {
+        det_cache_.invalidate();
+        return Array<T, Allocator>::begin();
+    }
+
+    iterator end() noexcept
+    {
+        det_cache_.invalidate();
+        return Array<T, Allocator>::end();
     }
 
+    reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Views. They are made in O(1) and stay valid until the matrix is resized or destroyed.
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    Matrix_View<value_type> view() noexcept { return {data(), n_rows_, n_cols_, stride()}; }
+    Const_Matrix_View<value_type> view() const noexcept { return {data(), n_rows_, n_cols_, stride()}; }
+
+    Matrix_View<value_type> block(size_type row_i, size_type col_i, size_type height, size_type width)
+    {
+        return view().block(row_i, col_i, height, width);
+    }
+
+    Const_Matrix_View<value_type> block(size_type row_i, size_type col_i,
+                                        size_type height, size_type width) const
+    {
+        return view().block(row_i, col_i, height, width);
+    }
+
+    Matrix_View<value_type> row_range(size_type first, size_type last)
+    {
+        return view().row_range(first, last);
+    }
+
+    Const_Matrix_View<value_type> row_range(size_type first, size_type last) const
+    {
+        return view().row_range(first, last);
+    }
+
+    Matrix_View<value_type> col_range(size_type first, size_type last)
+    {
+        return view().col_range(first, last);
+    }
+
+    Const_Matrix_View<value_type> col_range(size_type first, size_type last) const
+    {
+        return view().col_range(first, last);
+    }
+
+    // Unlike transpose(), doesn't move any element
+    Matrix_View<value_type> transposed() noexcept { return view().transposed(); }
+    Const_Matrix_View<value_type> transposed() const noexcept { return view().transposed(); }
+
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
     // Some convenient methods
@@ -163,70 +324,180 @@ public:
 
     bool is_square() const noexcept { return n_rows_ == n_cols_; }
 
+    // Square matrices are transposed in place. Others are copied into a new storage:
+    // that's the fastest way, but it needs memory for two matrices at a time.
     Matrix &transpose() &
     {
+        stats::Scope scope{stats::Op::transpose};
+        stats::add_bytes(2 * n_rows_ * n_cols_ * sizeof(value_type));
+        stats::Phase_Timer timer{stats::Phase::transposition};
+
         if (is_square())
-        {
-            for (size_type i = 0; i != n_rows_; ++i)
-                for (size_type j = i + 1; j != n_cols_; ++j)
-                    std::swap((*this)[i][j], (*this)[j][i]);
-        }
+            detail::transpose_square(n_rows_, data(), stride());
         else
         {
-            Matrix transposed{n_cols_, n_rows_};
-
-            for (size_type i = 0; i != n_rows_; ++i)
-                for (size_type j = 0; j != n_cols_; ++j)
-                    transposed[j][i] = (*this)[i][j];
-
+            Matrix transposed{n_cols_, n_rows_, default_init, get_allocator()};
+            detail::transpose_copy(n_rows_, n_cols_, data(), stride(),
+                                   transposed.data(), transposed.stride());
             std::swap(*this, transposed);
         }
 
         return *this;
     }
 
+    // Transposes a non-square matrix without a second storage by following the cycles
+    // of the permutation. It's slower than transpose() because of scattered accesses,
+    // but takes only one extra bit per element.
+    Matrix &transpose_in_place() &
+    {
+        if (is_square())
+            return transpose();
+
+        const auto new_stride = detail::row_stride<T, Allocator>(n_rows_);
+
+        // Padded rows of the result may not fit into the storage
+        if (n_cols_ * new_stride > size())
+            return transpose();
+
+        stats::Scope scope{stats::Op::transpose};
+        stats::add_bytes(2 * n_rows_ * n_cols_ * sizeof(value_type));
+        stats::Phase_Timer timer{stats::Phase::transposition};
+
+        // Padding is squeezed out before the transposition and inserted back after it
+        for (size_type i = 1; i < n_rows_ && stride() != n_cols_; ++i)
+            std::copy_n(data() + i * stride(), n_cols_, data() + i * n_cols_);
+
+        detail::transpose_cycles(n_rows_, n_cols_, data());
+        std::swap(n_rows_, n_cols_);
+
+        for (size_type i = n_rows_; i-- > 1 && stride() != n_cols_;)
+            std::copy_backward(data() + i * n_cols_, data() + (i + 1) * n_cols_,
+                               data() + i * stride() + n_cols_);
+
+        return *this;
+    }
+
+    // Triangular, tridiagonal, banded and block-diagonal matrices are detected by a pass which
+    // reads O(n) elements of a dense matrix (see detect_structure()) and get cheaper algorithms.
+    //
+    // If the project is configured with -DYLAB_DET_CACHE=ON, the result is kept until the matrix
+    // is modified, so repeated calls take O(1). Writes through rows, iterators, pointers and views
+    // obtained before the call aren't noticed then. The call modifies the cache, so concurrent
+    // calls on the same matrix need synchronization, as modifications do.
     value_type determinant() const
     {
         if (!is_square())
             throw Undef_Det{};
-        return Matrix{*this}.det_algorithm();
+
+        if (const value_type *cached = det_cache_.find())
+            return *cached;
+
+        stats::Scope scope{stats::Op::determinant};
+        const value_type determinant =
+            structured_determinant(detail::detect_structure(n_rows_, data(), stride()));
+        det_cache_.store(determinant);
+        return determinant;
+    }
+
+    // Skips the detection. The structure is trusted: elements outside of it aren't read, and
+    // the result isn't cached, though a cached one is returned. Offsets of blocks are checked.
+    value_type determinant(const Structure &structure) const
+    {
+        if (!is_square())
+            throw Undef_Det{};
+
+        if (const auto *blocks = std::get_if<structure::Block_Diagonal>(&structure);
+            blocks && !detail::are_valid_blocks(blocks->offsets, n_rows_))
+            throw Undef_Det{};
+
+        if (const value_type *cached = det_cache_.find())
+            return *cached;
+
+        stats::Scope scope{stats::Op::determinant};
+        return structured_determinant(structure);
     }
 
+    // Defined in lu.hpp
+    LU<T, Allocator> lu() const requires std::is_floating_point_v<T>;
+
+    // Defined in cholesky.hpp
+    Cholesky<T, Allocator> cholesky() const requires std::is_floating_point_v<T>;
+
+    // Defined in mixed_lu.hpp
+    Mixed_LU<T, Allocator> mixed_lu() const requires std::is_floating_point_v<T>;
+
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 
     // Arithmetic operators
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    Matrix &operator+=(const Matrix &rhs)
+    // Expressions are evaluated element by element, so the matrix itself may be an operand
+    // of the right-hand side. Operands which read it in another order (such as views of it)
+    // make the expression be evaluated into a new storage.
+    template<Matrix_Expression E>
+    requires (!std::is_same_v<std::remove_cvref_t<E>, Matrix> &&
+              std::is_same_v<expr_value_t<E>, value_type>)
+    Matrix &operator=(E &&expr)
+    {
+        if (n_rows_ == expr.n_rows() && n_cols_ == expr.n_cols() &&
+            !detail::aliases(expr, detail::matrix_layout(*this)))
+            assign_elementwise(expr);
+        else
+            *this = Matrix(std::forward<E>(expr), get_allocator());
+
+        return *this;
+    }
+
+    template<Matrix_Expression E>
+    requires std::is_same_v<expr_value_t<E>, value_type>
+    Matrix &operator+=(const E &rhs)
     {
-        if (!are_congruent(*this, rhs))
+        if (n_rows_ != rhs.n_rows() || n_cols_ != rhs.n_cols())
             throw Undef_Sum{};
 
-        std::transform(begin(), end(), rhs.begin(), begin(), std::plus<value_type>{});
+        if constexpr (std::is_same_v<E, Matrix> && detail::simd::is_vectorizable_v<value_type>)
+            detail::simd::add(size(), data(), rhs.data());
+        else if (detail::aliases(rhs, detail::matrix_layout(*this)))
+            apply_elementwise(Matrix(rhs, get_allocator()), std::plus<value_type>{});
+        else
+            apply_elementwise(rhs, std::plus<value_type>{});
         return *this;
     }
 
-    Matrix &operator-=(const Matrix &rhs)
+    template<Matrix_Expression E>
+    requires std::is_same_v<expr_value_t<E>, value_type>
+    Matrix &operator-=(const E &rhs)
     {
-        if (!are_congruent(*this, rhs))
+        if (n_rows_ != rhs.n_rows() || n_cols_ != rhs.n_cols())
             throw Undef_Diff{};
 
-        std::transform(begin(), end(), rhs.begin(), begin(), std::minus<value_type>{});
+        if constexpr (std::is_same_v<E, Matrix> && detail::simd::is_vectorizable_v<value_type>)
+            detail::simd::subtract(size(), data(), rhs.data());
+        else if (detail::aliases(rhs, detail::matrix_layout(*this)))
+            apply_elementwise(Matrix(rhs, get_allocator()), std::minus<value_type>{});
+        else
+            apply_elementwise(rhs, std::minus<value_type>{});
         return *this;
     }
 
     Matrix &operator*=(const value_type &value)
     {
-        std::transform(begin(), end(), begin(),
-                       [&value](const value_type &elem){ return elem * value; });
+        if constexpr (detail::simd::is_vectorizable_v<value_type>)
+            detail::simd::multiply(size(), data(), value);
+        else
+            std::transform(begin(), end(), begin(),
+                           [&value](const value_type &elem){ return elem * value; });
         return *this;
     }
 
     Matrix &operator/=(const value_type &value)
     {
-        std::transform(begin(), end(), begin(),
-                       [&value](const value_type &elem){ return elem / value; });
+        if constexpr (detail::simd::is_vectorizable_v<value_type>)
+            detail::simd::divide(size(), data(), value);
+        else
+            std::transform(begin(), end(), begin(),
+                           [&value](const value_type &elem){ return elem / value; });
         return *this;
     }
 
@@ -234,50 +505,193 @@ public:
 
 private:
 
-    // Gauss algorithm
-    value_type det_algorithm()
-    requires std::is_floating_point_v<value_type>
+    Matrix(size_type n_rows, size_type n_cols, Default_Init_Tag,
+           const allocator_type &alloc = allocator_type{})
+        : Array<T, Allocator>(n_rows * detail::row_stride<T, Allocator>(n_cols), default_init,
+                              alloc),
+          n_rows_{n_rows}, n_cols_{n_cols}
     {
-        auto exchanges = 0;
+        // Only the elements are left to the caller. Padding is copied and takes part in
+        // the SIMD kernels run over the whole storage, so it mustn't be indeterminate.
+        if (stride() != n_cols_)
+            for (size_type i = 0; i != n_rows_; ++i)
+                std::fill(data() + i * stride() + n_cols_, data() + (i + 1) * stride(),
+                          value_type{});
+    }
 
-        size_type row_i = 0;
-        size_type col_i = 0;
+    // alloc == nullptr means the allocator of the owned operand, if there is one
+    template<typename E>
+    static Matrix evaluate(E &&expr, const allocator_type *alloc)
+    {
+        if constexpr (!std::is_lvalue_reference_v<E>)
+        {
+            Matrix *owned = expr.template owned_matrix<Matrix>();
+            if (owned && (!alloc || owned->get_allocator() == *alloc) &&
+                !expr.aliases(detail::matrix_layout(*owned)))
+            {
+                owned->assign_elementwise(expr);
+                return std::move(*owned);
+            }
+        }
 
-        while (row_i < n_rows_ && col_i < n_cols_)
+        Matrix result{expr.n_rows(), expr.n_cols(), default_init, alloc ? *alloc : allocator_type{}};
+        result.assign_elementwise(expr);
+        return result;
+    }
+
+    template<typename E>
+    void assign_elementwise(const E &expr)
+    {
+        for (size_type i = 0; i != n_rows_; ++i)
         {
-            const auto [pivot_pos, pivot] = find_pivot(row_i, col_i);
+            value_type *row = data() + i * stride();
+            for (size_type j = 0; j != n_cols_; ++j)
+                row[j] = detail::element(expr, i, j);
+        }
+    }
 
-            if (pivot == value_type{})
-                return value_type{};
-            else
+    template<typename E, typename Op>
+    void apply_elementwise(const E &expr, Op op)
+    {
+        for (size_type i = 0; i != n_rows_; ++i)
+        {
+            value_type *row = data() + i * stride();
+            for (size_type j = 0; j != n_cols_; ++j)
+                row[j] = op(row[j], detail::element(expr, i, j));
+        }
+    }
+
+    value_type structured_determinant(const Structure &structure) const
+    {
+        const auto n = n_rows_;
+        const value_type *elems = data();
+        const auto ld = stride();
+
+        const value_type determinant = std::visit([&, this]<typename S>(const S &kind) -> value_type
+        {
+            if constexpr (std::is_same_v<S, structure::Diagonal> ||
+                          std::is_same_v<S, structure::Lower_Triangular> ||
+                          std::is_same_v<S, structure::Upper_Triangular>)
+                return detail::diagonal_product(n, elems, ld);
+            else if constexpr (std::is_same_v<S, structure::Tridiagonal>)
             {
-                if (row_i != pivot_pos)
+                if constexpr (std::is_integral_v<value_type>)
+                    return detail::tridiagonal_determinant(n, elems, ld);
+                else
+                    return detail::banded_determinant(n, elems, ld, 1, 1);
+            }
+            else if constexpr (std::is_same_v<S, structure::Banded>)
+            {
+                stats::add_flops(2 * n * kind.lower * (kind.lower + kind.upper + 1));
+                return detail::banded_determinant(n, elems, ld, kind.lower, kind.upper);
+            }
+            else if constexpr (std::is_same_v<S, structure::Block_Diagonal>)
+            {
+                // Blocks may have structure of their own
+                value_type product{1};
+                for (size_type k = 0; k + 1 < kind.offsets.size(); ++k)
                 {
-                    swap_rows(row_i, pivot_pos);
-                    ++exchanges;
+                    const auto first = kind.offsets[k];
+                    const auto size = kind.offsets[k + 1] - first;
+                    const Matrix block{view().block(first, first, size, size), this->get_allocator()};
+                    product *= block.structured_determinant(
+                        detail::detect_structure(size, block.data(), block.stride()));
                 }
+                return product;
+            }
+            else
+            {
+                Matrix copy{*this, this->get_allocator()};
+                stats::add_bytes(n * n * sizeof(value_type));
+                return copy.eliminate(*this);
+            }
+        }, structure);
 
-                for (size_type i = row_i + 1; i != n_cols_; ++i)
-                {
-                    const value_type coeff = (*this)[i][col_i] / (*this)[row_i][col_i];
-                    (*this)[i][col_i] = value_type{};
+        return snap_to_zero(determinant);
+    }
 
-                    for (size_type j = col_i + 1; j != n_rows_; ++j)
-                        (*this)[i][j] -= (*this)[row_i][j] * coeff;
-                }
+    // Determinant of source, a copy of which the matrix is. The copy is the storage
+    // of elimination, so the elements are copied only once.
+    template<Matrix_Expression E>
+    value_type scratch_determinant(const E &source)
+    {
+        stats::Scope scope{stats::Op::determinant};
+        const auto structure = detail::detect_structure(n_rows_, data(), stride());
+        if (std::holds_alternative<structure::General>(structure))
+            return snap_to_zero(eliminate(source));
+        return structured_determinant(structure);
+    }
+
+    // Determinant of a general matrix computed in place. Symmetric matrices with a positive
+    // diagonal are tried by Cholesky decomposition, which takes n^3 / 3 operations. If a pivot
+    // isn't positive, the elements are copied from source again and go on to elimination.
+    template<Matrix_Expression E>
+    value_type eliminate(const E &source)
+    {
+        const auto n = n_rows_;
+
+        if constexpr (std::is_floating_point_v<value_type>)
+            if (detail::has_positive_diagonal(n, data(), stride()) &&
+                detail::is_symmetric(n, data(), stride()))
+            {
+                stats::add_flops(n * n * n / 3);
+                if (detail::cholesky_decompose(Thread_Pool::default_pool(), n, data(), stride()))
+                    return detail::cholesky_determinant(n, data(), stride());
 
-                ++row_i;
-                ++col_i;
+                assign_elementwise(source);
+                stats::add_bytes(n * n * sizeof(value_type));
             }
-        }
 
-        value_type determinant = (*this)[0][0];
-        for (size_type diag_i = 1; diag_i != n_cols_; ++diag_i)
-            determinant *= (*this)[diag_i][diag_i];
+        // Gaussian elimination takes 2/3 * n^3 operations, Bareiss algorithm twice as many
+        stats::add_flops((std::is_integral_v<value_type> ? 4 : 2) * n * n * n / 3);
+        return det_algorithm();
+    }
+
+    static value_type snap_to_zero(value_type determinant)
+    {
+        if constexpr (std::is_floating_point_v<value_type>)
+            if (yLab::cmp::are_equal(determinant, value_type{}))
+                return value_type{};
+        return determinant;
+    }
+
+    // Gauss algorithm. Large matrices are decomposed by tiled LU on all cores
+    value_type det_algorithm()
+    requires std::is_floating_point_v<value_type>
+    {
+        using Size_Alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>;
+        std::vector<size_type, Size_Alloc> perm(n_rows_, Size_Alloc{get_allocator()});
+        stats::count_allocation();
+        value_type determinant;
+
+        if (n_rows_ >= detail::tiled_lu_threshold)
+        {
+            int sign;
+            {
+                stats::Phase_Timer timer{stats::Phase::elimination};
+                sign = detail::tiled_lu_decompose(Thread_Pool::default_pool(),
+                                                  n_rows_, data(), stride(), perm.data());
+            }
+
+            // perm[i] is the row swapped with row i
+            if constexpr (stats::enabled)
+                for (size_type i = 0; i != n_rows_; ++i)
+                    if (perm[i] != i)
+                        stats::add_pivot_swaps();
+
+            // Rows are swapped physically, so the factors are addressed directly
+            std::iota(perm.begin(), perm.end(), size_type{0});
+            determinant = detail::lu_determinant(n_rows_, data(), stride(), perm.data(), sign);
+        }
+        else
+        {
+            const int sign = detail::lu_decompose(n_rows_, data(), stride(), perm.data());
+            determinant = detail::lu_determinant(n_rows_, data(), stride(), perm.data(), sign);
+        }
 
         if (yLab::cmp::are_equal(determinant, value_type{}))
             return value_type{};
-        return (exchanges % 2) ? -determinant : determinant;
+        return determinant;
     }
 
     // Bareiss algorithm
@@ -290,7 +704,11 @@ private:
 
         for (size_type row_i = 0; row_i != n_rows_ - 1; ++row_i)
         {
-            const auto [pivot_pos, pivot] = find_pivot(row_i, row_i);
+            const auto [pivot_pos, pivot] = [&]
+            {
+                stats::Phase_Timer timer{stats::Phase::pivot_search};
+                return find_pivot(row_i, row_i);
+            }();
 
             if (pivot == value_type{})
                 return value_type{};
@@ -298,19 +716,22 @@ private:
             {
                 if (row_i != pivot_pos)
                 {
+                    stats::Phase_Timer timer{stats::Phase::row_swap};
+                    stats::add_pivot_swaps();
                     swap_rows(row_i, pivot_pos);
                     ++exchanges;
                 }
 
+                stats::Phase_Timer timer{stats::Phase::elimination};
                 const value_type value_1 = (*this)[row_i][row_i];
 
                 for (size_type i = row_i + 1; i != n_cols_; ++i)
                 {
                     const auto value_2 = std::exchange((*this)[i][row_i], value_type{});
 
-                    for (size_type j = row_i + 1; j != n_rows_; ++j)
-                        (*this)[i][j] = ((*this)[i][j] * value_1 -
-                                         (*this)[row_i][j] * value_2) / init_val;
+                    detail::simd::bareiss_update(n_cols_ - row_i - 1, &(*this)[i][row_i + 1],
+                                                 &(*this)[row_i][row_i + 1],
+                                                 value_1, value_2, init_val);
                 }
 
                 init_val = value_1;
@@ -341,88 +762,371 @@ private:
 
     void swap_rows(size_type row_1, size_type row_2)
     {
-        std::swap_ranges(begin() + row_1 * n_cols_, begin() + (row_1 + 1) * n_cols_,
-                         begin() + row_2 * n_cols_);
+        std::swap_ranges(begin() + row_1 * stride(), begin() + row_1 * stride() + n_cols_,
+                         begin() + row_2 * stride());
     }
 
     size_type n_rows_;
     size_type n_cols_;
+    [[no_unique_address]] detail::Determinant_Cache<value_type> det_cache_;
 };
 
+namespace detail
+{
+
+template<typename T, typename Allocator>
+struct is_matrix<Matrix<T, Allocator>> : std::true_type {};
+
+} // namespace detail
+
+namespace pmr
+{
+
+// Matrix whose storage comes from a std::pmr::memory_resource
+template<typename T>
+using Matrix = yLab::Matrix<T, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+
+// Matrix with 64-byte aligned rows
 template<typename T>
-bool operator==(const Matrix<T> &lhs, const Matrix<T> &rhs)
+using Aligned_Matrix = Matrix<T, Aligned_Allocator<T>>;
+
+template<Matrix_Expression L, Matrix_Expression R>
+bool operator==(const L &lhs, const R &rhs)
 {
-    if (&lhs == &rhs)
-        return true;
-    else if (!Matrix<T>::are_congruent(lhs, rhs))
+    if constexpr (std::is_same_v<L, R> && is_matrix_v<L>)
+    {
+        if (&lhs == &rhs)
+            return true;
+        else if (!L::are_congruent(lhs, rhs))
+            return false;
+        else if (lhs.stride() == lhs.n_cols())
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    if (lhs.n_rows() != rhs.n_rows() || lhs.n_cols() != rhs.n_cols())
         return false;
-    else
-        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+
+    // Padding elements, if any, are skipped
+    for (std::size_t i = 0; i != lhs.n_rows(); ++i)
+        for (std::size_t j = 0; j != lhs.n_cols(); ++j)
+            if (detail::element(lhs, i, j) != detail::element(rhs, i, j))
+                return false;
+    return true;
 }
 
-template<typename T>
-Matrix<T> operator+(const Matrix<T> &lhs, const Matrix<T> &rhs)
+// Arithmetic operators build lazy expressions; see matrix_expr.hpp
+
+template<Matrix_Expression L, Matrix_Expression R>
+requires std::is_same_v<expr_value_t<L>, expr_value_t<R>>
+auto operator+(L &&lhs, R &&rhs)
 {
-    auto sum = lhs;
-    return sum += rhs;
+    if (lhs.n_rows() != rhs.n_rows() || lhs.n_cols() != rhs.n_cols())
+        throw Undef_Sum{};
+
+    return detail::Binary_Expr<detail::as_expr_t<L>, detail::as_expr_t<R>,
+                               std::plus<expr_value_t<L>>>{detail::as_expr(std::forward<L>(lhs)),
+                                                           detail::as_expr(std::forward<R>(rhs))};
 }
 
-template<typename T>
-Matrix<T> operator-(const Matrix<T> &lhs, const Matrix<T> &rhs)
+template<Matrix_Expression L, Matrix_Expression R>
+requires std::is_same_v<expr_value_t<L>, expr_value_t<R>>
+auto operator-(L &&lhs, R &&rhs)
 {
-    auto diff = lhs;
-    return diff -= rhs;
+    if (lhs.n_rows() != rhs.n_rows() || lhs.n_cols() != rhs.n_cols())
+        throw Undef_Diff{};
+
+    return detail::Binary_Expr<detail::as_expr_t<L>, detail::as_expr_t<R>,
+                               std::minus<expr_value_t<L>>>{detail::as_expr(std::forward<L>(lhs)),
+                                                            detail::as_expr(std::forward<R>(rhs))};
 }
 
-template<typename T>
-Matrix<T> operator*(const Matrix<T> &lhs, const T &value)
+template<Matrix_Expression E>
+auto operator*(E &&lhs, const typename std::remove_cvref_t<E>::value_type &value)
 {
-    auto mult = lhs;
-    return mult *= value;
+    return detail::Scalar_Expr<detail::as_expr_t<E>,
+                               std::multiplies<expr_value_t<E>>>{detail::as_expr(std::forward<E>(lhs)),
+                                                                 value};
 }
 
-template<typename T>
-Matrix<T> operator*(const T &value, const Matrix<T> &lhs) { return lhs * value; }
+template<Matrix_Expression E>
+auto operator*(const typename std::remove_cvref_t<E>::value_type &value, E &&rhs)
+{
+    return std::forward<E>(rhs) * value;
+}
 
-template<typename T>
-Matrix<T> operator/(const Matrix<T> &lhs, const T &value)
+template<Matrix_Expression E>
+auto operator/(E &&lhs, const typename std::remove_cvref_t<E>::value_type &value)
 {
-    auto div = lhs;
-    return div /= value;
+    return detail::Scalar_Expr<detail::as_expr_t<E>,
+                               std::divides<expr_value_t<E>>>{detail::as_expr(std::forward<E>(lhs)),
+                                                              value};
 }
 
+namespace detail
+{
+
+// (m x k) * (k x n) takes 2 * m * n * k operations; both operands are read and the result is written
 template<typename T>
-Matrix<T> product(const Matrix<T> &lhs, const Matrix<T> &rhs)
+void count_product(std::size_t m, std::size_t n, std::size_t k) noexcept
+{
+    stats::add_flops(2 * m * n * k);
+    stats::add_bytes((m * k + k * n + m * n) * sizeof(T));
+}
+
+// lhs * rhs by the algorithm, where gemm(m, n, k, a, lda, b, ldb, c, ldc) computes C += A * B
+// and is the base case of Strassen-Winograd algorithm. The product is allocated
+// by the allocator of lhs.
+template<typename T, typename Allocator, Product_Algorithm Algorithm, typename Gemm>
+Matrix<T, Allocator> matrix_product(const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs,
+                                    Algorithm algorithm, Gemm gemm)
 {
     if (lhs.n_cols() != rhs.n_rows())
         throw Undef_Product{};
 
-    Matrix<T> product{lhs.n_rows(), rhs.n_cols()};
+    const auto m = lhs.n_rows();
+    const auto n = rhs.n_cols();
+    const auto k = lhs.n_cols();
 
-    for (std::size_t i = 0; i != lhs.n_rows(); ++i)
-        for (std::size_t j = 0; j != rhs.n_cols(); ++j)
-            for (std::size_t k = 0; k != lhs.n_cols(); ++k)
-                product[i][j] += lhs[i][k] * rhs[k][j];
+    stats::Scope scope{stats::Op::product};
+    count_product<T>(m, n, k);
+
+    bool use_strassen = false;
+    std::size_t cutoff = strassen_cutoff;
+    if constexpr (std::is_same_v<Algorithm, algorithm::Strassen>)
+    {
+        use_strassen = m == n && n == k;
+        cutoff = algorithm.cutoff;
+    }
+    else if constexpr (std::is_same_v<Algorithm, algorithm::Automatic>)
+        use_strassen = prefers_strassen<T>(m, n, k);
+
+    Matrix<T, Allocator> product{m, n, T{}, lhs.get_allocator()};
+
+    stats::Phase_Timer timer{stats::Phase::multiplication};
+    if (use_strassen)
+    {
+        strassen_product(n, lhs.data(), lhs.stride(), rhs.data(), rhs.stride(),
+                         product.data(), product.stride(), cutoff, gemm);
+        return product;
+    }
+
+    gemm(m, n, k, lhs.data(), lhs.stride(), rhs.data(), rhs.stride(), product.data(), product.stride());
 
     return product;
 }
 
+} // namespace detail
+
+// The product is allocated by the allocator of lhs
+template<typename T, typename Allocator, Product_Algorithm Algorithm>
+Matrix<T, Allocator> product(const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs,
+                             Algorithm algorithm)
+{
+    return detail::matrix_product(lhs, rhs, algorithm, [](auto... args){ detail::gemm(args...); });
+}
+
+template<typename T, typename Allocator>
+Matrix<T, Allocator> product(const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs)
+{
+    return product(lhs, rhs, algorithm::automatic);
+}
+
+namespace detail
+{
+
+template<typename E>
+inline constexpr bool is_view_v = false;
+
 template<typename T>
-void dump(std::ostream &os, const Matrix<T> &matrix)
+inline constexpr bool is_view_v<Matrix_View<T>> = true;
+
+// Matrices and views can be passed to gemm as they are
+template<typename E>
+inline constexpr bool has_layout_v = is_matrix_v<E> || is_view_v<std::remove_cvref_t<E>>;
+
+template<typename E>
+Layout<expr_value_t<E>> layout_of(const E &expr) noexcept
 {
-    os.setf(std::ios::left);
+    if constexpr (is_matrix_v<E>)
+        return matrix_layout(expr);
+    else
+        return expr.layout();
+}
+
+// Evaluates an expression which isn't a matrix or a view, preferably with the allocator
+// of the other operand of the product
+template<typename E, typename Other>
+auto product_operand(const E &expr, const Other &other)
+{
+    if constexpr (is_matrix_v<Other>)
+        return Other(expr, other.get_allocator());
+    else
+        return Matrix<expr_value_t<E>>(expr);
+}
 
-    for (std::size_t i = 1; auto &elem : matrix)
+// lhs * rhs, where gemm(m, n, k, a_layout, b_layout, c, ldc) computes C += A * B.
+// The product uses the allocator of a matrix operand, if there is one.
+template<typename L, typename R, typename Gemm>
+auto strided_product(const L &lhs, const R &rhs, Gemm gemm)
+{
+    using T = expr_value_t<L>;
+
+    if (lhs.n_cols() != rhs.n_rows())
+        throw Undef_Product{};
+
+    stats::Scope scope{stats::Op::product};
+    count_product<T>(lhs.n_rows(), rhs.n_cols(), lhs.n_cols());
+
+    auto product = [&]
     {
-        if (i++ % matrix.n_cols())
-            os << std::setw(5) << elem << ' ';
+        if constexpr (is_matrix_v<L>)
+            return L(lhs.n_rows(), rhs.n_cols(), T{}, lhs.get_allocator());
+        else if constexpr (is_matrix_v<R>)
+            return R(lhs.n_rows(), rhs.n_cols(), T{}, rhs.get_allocator());
         else
-            os << elem << '\n';
-    }
+            return Matrix<T>(lhs.n_rows(), rhs.n_cols());
+    }();
+
+    stats::Phase_Timer timer{stats::Phase::multiplication};
+    gemm(lhs.n_rows(), rhs.n_cols(), lhs.n_cols(), layout_of(lhs), layout_of(rhs),
+         product.data(), product.stride());
+
+    return product;
+}
+
+} // namespace detail
+
+// Views are multiplied without copying whatever their strides are, e.g. product(a.transposed(), b).
+// Other expressions are evaluated first.
+template<Matrix_Expression L, Matrix_Expression R>
+requires (!(is_matrix_v<L> && is_matrix_v<R>) && std::is_same_v<expr_value_t<L>, expr_value_t<R>>)
+auto product(const L &lhs, const R &rhs)
+{
+    if constexpr (!detail::has_layout_v<L>)
+        return product(detail::product_operand(lhs, rhs), rhs);
+    else if constexpr (!detail::has_layout_v<R>)
+        return product(lhs, detail::product_operand(rhs, lhs));
+    else
+        return detail::strided_product(lhs, rhs, [](auto m, auto n, auto k, auto a, auto b, auto *c, auto ldc)
+        {
+            detail::gemm_strided(m, n, k, a.data, a.row_stride, a.col_stride,
+                                 b.data, b.row_stride, b.col_stride, c, ldc);
+        });
 }
 
+template<typename T, typename Allocator, Product_Algorithm Algorithm>
+Matrix<T, Allocator> product(execution::Sequenced_Policy,
+                             const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs,
+                             Algorithm algorithm)
+{
+    return product(lhs, rhs, algorithm);
+}
+
+template<typename T, typename Allocator>
+Matrix<T, Allocator> product(execution::Sequenced_Policy,
+                             const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs)
+{
+    return product(lhs, rhs);
+}
+
+// Strassen-Winograd algorithm runs its base case products in parallel
+template<typename T, typename Allocator, Product_Algorithm Algorithm>
+Matrix<T, Allocator> product(const execution::Parallel_Policy &policy,
+                             const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs,
+                             Algorithm algorithm)
+{
+    return detail::matrix_product(lhs, rhs, algorithm, [&policy](auto... args)
+    {
+        detail::parallel_gemm(policy.get_pool(), args...);
+    });
+}
+
+template<typename T, typename Allocator>
+Matrix<T, Allocator> product(const execution::Parallel_Policy &policy,
+                             const Matrix<T, Allocator> &lhs, const Matrix<T, Allocator> &rhs)
+{
+    return product(policy, lhs, rhs, algorithm::automatic);
+}
+
+template<Matrix_Expression L, Matrix_Expression R>
+requires (!(is_matrix_v<L> && is_matrix_v<R>) && std::is_same_v<expr_value_t<L>, expr_value_t<R>>)
+auto product(execution::Sequenced_Policy, const L &lhs, const R &rhs)
+{
+    return product(lhs, rhs);
+}
+
+template<Matrix_Expression L, Matrix_Expression R>
+requires (!(is_matrix_v<L> && is_matrix_v<R>) && std::is_same_v<expr_value_t<L>, expr_value_t<R>>)
+auto product(const execution::Parallel_Policy &policy, const L &lhs, const R &rhs)
+{
+    if constexpr (!detail::has_layout_v<L>)
+        return product(policy, detail::product_operand(lhs, rhs), rhs);
+    else if constexpr (!detail::has_layout_v<R>)
+        return product(policy, lhs, detail::product_operand(rhs, lhs));
+    else
+        return detail::strided_product(lhs, rhs, [&policy](auto m, auto n, auto k, auto a, auto b,
+                                                           auto *c, auto ldc)
+        {
+            detail::parallel_gemm_strided(policy.get_pool(), m, n, k,
+                                          a.data, a.row_stride, a.col_stride,
+                                          b.data, b.row_stride, b.col_stride, c, ldc);
+        });
+}
+
+// Views
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
 template<typename T>
-std::ostream &operator<<(std::ostream &os, const Matrix<T> &matrix)
+requires std::is_arithmetic_v<T>
+auto Matrix_View<T>::determinant() const -> value_type
+{
+    if (!is_square())
+        throw Undef_Det{};
+
+    Matrix<value_type> copy{*this};
+    stats::add_bytes(n_rows() * n_cols() * sizeof(value_type));
+    return copy.scratch_determinant(*this);
+}
+
+template<typename T>
+requires std::is_arithmetic_v<T>
+template<typename Error, typename E, typename F>
+auto Matrix_View<T>::update(const E &expr, F func) const -> const Matrix_View &
+{
+    if (n_rows_ != expr.n_rows() || n_cols_ != expr.n_cols())
+        throw Error{};
+
+    if (detail::aliases(expr, layout()))
+        return update<Error>(Matrix<value_type>(expr), func);
+
+    for (size_type i = 0; i != n_rows_; ++i)
+        for (size_type j = 0; j != n_cols_; ++j)
+            func((*this)(i, j), detail::element(expr, i, j));
+
+    return *this;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template<Matrix_Expression E>
+void dump(std::ostream &os, const E &matrix)
+{
+    os.setf(std::ios::left);
+
+    for (std::size_t i = 0; i != matrix.n_rows(); ++i)
+        for (std::size_t j = 0; j != matrix.n_cols(); ++j)
+        {
+            if (j + 1 != matrix.n_cols())
+                os << std::setw(5) << detail::element(matrix, i, j) << ' ';
+            else
+                os << detail::element(matrix, i, j) << '\n';
+        }
+}
+
+template<Matrix_Expression E>
+std::ostream &operator<<(std::ostream &os, const E &matrix)
 {
     dump(os, matrix);
     return os;
@@ -0,0 +1,264 @@
+#ifndef INCLUDE_MATRIX_EXPR_HPP
+#define INCLUDE_MATRIX_EXPR_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace yLab
+{
+
+// Lazy matrix expressions. Every node models the following interface:
+//   value_type, size_type;
+//   n_rows(), n_cols();
+//   operator()(i, j)     - computes element (i, j) of the result;
+//   owned_matrix<M>()    - pointer to a matrix of type M owned by the expression, if any;
+//   aliases(layout)      - whether the expression reads memory described by layout
+//                          otherwise than element (i, j) from position (i, j).
+// Nothing is computed until an expression is assigned to a Matrix. Then every element
+// of the result is evaluated in a single pass without temporaries, unless the expression
+// aliases the destination (e.g. m = m.transposed()).
+
+namespace detail
+{
+
+// Specialized for Matrix in matrix.hpp
+template<typename T>
+struct is_matrix : std::false_type {};
+
+template<typename T>
+struct is_expr_node : std::false_type {};
+
+} // namespace detail
+
+template<typename T>
+inline constexpr bool is_matrix_v = detail::is_matrix<std::remove_cvref_t<T>>::value;
+
+template<typename T>
+concept Matrix_Expression = is_matrix_v<T> || detail::is_expr_node<std::remove_cvref_t<T>>::value;
+
+template<Matrix_Expression E>
+using expr_value_t = typename std::remove_cvref_t<E>::value_type;
+
+namespace detail
+{
+
+// Element (i, j) is stored at data[i * row_stride + j * col_stride]
+template<typename T>
+struct Layout final
+{
+    const T *data;
+    std::size_t n_rows;
+    std::size_t n_cols;
+    std::size_t row_stride;
+    std::size_t col_stride;
+
+    const T *first() const noexcept { return data; }
+
+    const T *last() const noexcept
+    {
+        if (n_rows == 0 || n_cols == 0)
+            return data;
+        return data + (n_rows - 1) * row_stride + (n_cols - 1) * col_stride + 1;
+    }
+};
+
+// Whether writing dst element by element may clobber an element of src which hasn't been
+// read yet. Overlapping layouts are safe only if they map every (i, j) to the same address.
+template<typename T>
+bool may_alias(const Layout<T> &src, const Layout<T> &dst) noexcept
+{
+    if (src.first() >= dst.last() || dst.first() >= src.last())
+        return false;
+
+    return src.data != dst.data || src.row_stride != dst.row_stride ||
+           (src.n_cols > 1 && src.col_stride != dst.col_stride);
+}
+
+template<typename M>
+Layout<typename M::value_type> matrix_layout(const M &matrix) noexcept
+{
+    return {matrix.data(), matrix.n_rows(), matrix.n_cols(), matrix.stride(), 1};
+}
+
+// Leaf referring to a matrix which outlives the expression
+template<typename M>
+class Matrix_Ref final
+{
+public:
+
+    using value_type = typename M::value_type;
+    using size_type = typename M::size_type;
+
+    explicit Matrix_Ref(const M &matrix) noexcept : matrix_{matrix} {}
+
+    size_type n_rows() const noexcept { return matrix_.n_rows(); }
+    size_type n_cols() const noexcept { return matrix_.n_cols(); }
+
+    value_type operator()(size_type i, size_type j) const { return matrix_[i][j]; }
+
+    template<typename Other_M>
+    Other_M *owned_matrix() noexcept { return nullptr; }
+
+    bool aliases(const Layout<value_type> &dst) const noexcept
+    {
+        return may_alias(matrix_layout(matrix_), dst);
+    }
+
+private:
+
+    const M &matrix_;
+};
+
+// Leaf owning a matrix which was an rvalue operand. Its storage may be reused
+// for the result of the expression.
+template<typename M>
+class Matrix_Owner final
+{
+public:
+
+    using value_type = typename M::value_type;
+    using size_type = typename M::size_type;
+
+    explicit Matrix_Owner(M &&matrix) noexcept : matrix_{std::move(matrix)} {}
+
+    size_type n_rows() const noexcept { return matrix_.n_rows(); }
+    size_type n_cols() const noexcept { return matrix_.n_cols(); }
+
+    value_type operator()(size_type i, size_type j) const { return matrix_[i][j]; }
+
+    template<typename Other_M>
+    Other_M *owned_matrix() noexcept
+    {
+        if constexpr (std::is_same_v<Other_M, M>)
+            return &matrix_;
+        else
+            return nullptr;
+    }
+
+    bool aliases(const Layout<value_type> &dst) const noexcept
+    {
+        return may_alias(matrix_layout(matrix_), dst);
+    }
+
+private:
+
+    M matrix_;
+};
+
+template<typename L, typename R, typename Op>
+class Binary_Expr final
+{
+public:
+
+    using value_type = typename L::value_type;
+    using size_type = typename L::size_type;
+
+    Binary_Expr(L lhs, R rhs) : lhs_{std::move(lhs)}, rhs_{std::move(rhs)} {}
+
+    size_type n_rows() const noexcept { return lhs_.n_rows(); }
+    size_type n_cols() const noexcept { return lhs_.n_cols(); }
+
+    value_type operator()(size_type i, size_type j) const { return Op{}(lhs_(i, j), rhs_(i, j)); }
+
+    template<typename M>
+    M *owned_matrix() noexcept
+    {
+        if (auto owned = lhs_.template owned_matrix<M>())
+            return owned;
+        return rhs_.template owned_matrix<M>();
+    }
+
+    bool aliases(const Layout<value_type> &dst) const noexcept
+    {
+        return lhs_.aliases(dst) || rhs_.aliases(dst);
+    }
+
+private:
+
+    L lhs_;
+    R rhs_;
+};
+
+// Applies Op to every element and a scalar
+template<typename E, typename Op>
+class Scalar_Expr final
+{
+public:
+
+    using value_type = typename E::value_type;
+    using size_type = typename E::size_type;
+
+    Scalar_Expr(E expr, const value_type &value) : expr_{std::move(expr)}, value_{value} {}
+
+    size_type n_rows() const noexcept { return expr_.n_rows(); }
+    size_type n_cols() const noexcept { return expr_.n_cols(); }
+
+    value_type operator()(size_type i, size_type j) const { return Op{}(expr_(i, j), value_); }
+
+    template<typename M>
+    M *owned_matrix() noexcept { return expr_.template owned_matrix<M>(); }
+
+    bool aliases(const Layout<value_type> &dst) const noexcept { return expr_.aliases(dst); }
+
+private:
+
+    E expr_;
+    value_type value_;
+};
+
+template<typename M>
+struct is_expr_node<Matrix_Ref<M>> : std::true_type {};
+
+template<typename M>
+struct is_expr_node<Matrix_Owner<M>> : std::true_type {};
+
+template<typename L, typename R, typename Op>
+struct is_expr_node<Binary_Expr<L, R, Op>> : std::true_type {};
+
+template<typename E, typename Op>
+struct is_expr_node<Scalar_Expr<E, Op>> : std::true_type {};
+
+// Turns an operand into an expression node: lvalue matrices are referred to,
+// rvalue matrices are moved into the expression, nodes are copied or moved
+template<Matrix_Expression E>
+auto as_expr(E &&expr)
+{
+    using Expr_T = std::remove_cvref_t<E>;
+
+    if constexpr (!is_matrix_v<E>)
+        return Expr_T(std::forward<E>(expr));
+    else if constexpr (std::is_lvalue_reference_v<E>)
+        return Matrix_Ref<Expr_T>{expr};
+    else
+        return Matrix_Owner<Expr_T>{std::move(expr)};
+}
+
+template<Matrix_Expression E>
+using as_expr_t = decltype(as_expr(std::declval<E>()));
+
+// Element (i, j) of a matrix or an expression node
+template<Matrix_Expression E>
+decltype(auto) element(const E &expr, std::size_t i, std::size_t j)
+{
+    if constexpr (is_matrix_v<E>)
+        return expr[i][j];
+    else
+        return expr(i, j);
+}
+
+template<Matrix_Expression E>
+bool aliases(const E &expr, const Layout<expr_value_t<E>> &dst) noexcept
+{
+    if constexpr (is_matrix_v<E>)
+        return may_alias(matrix_layout(expr), dst);
+    else
+        return expr.aliases(dst);
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_MATRIX_EXPR_HPP
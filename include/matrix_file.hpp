@@ -0,0 +1,279 @@
+#ifndef INCLUDE_MATRIX_FILE_HPP
+#define INCLUDE_MATRIX_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "matrix.hpp"
+
+namespace yLab
+{
+
+// Binary matrix files. A file is a 64-byte header followed by n_rows rows of stride elements
+// each, of which the first n_cols are the row of the matrix. Elements are stored as they lie
+// in memory, so a file is mapped and used as a read-only view without parsing or copying.
+// The data begin at a 64-byte boundary, hence padded rows of Aligned_Matrix stay aligned.
+
+struct Bad_Matrix_File final : public std::runtime_error
+{
+    explicit Bad_Matrix_File(const std::string &what)
+        : std::runtime_error{"Bad matrix file: " + what} {};
+};
+
+enum class Elem_Type : std::uint8_t
+{
+    i8 = 1, i16, i32, i64,
+    u8, u16, u32, u64,
+    f32, f64
+};
+
+namespace detail
+{
+
+template<typename T>
+constexpr Elem_Type elem_type_of()
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "Only arithmetic types can be stored in a matrix file");
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 32- and 64-bit floating point types are supported");
+        return (sizeof(T) == 4) ? Elem_Type::f32 : Elem_Type::f64;
+    }
+    else
+    {
+        constexpr auto log_size = (sizeof(T) == 1) ? 0 : (sizeof(T) == 2) ? 1 : (sizeof(T) == 4) ? 2 : 3;
+        constexpr auto first = std::is_signed_v<T> ? Elem_Type::i8 : Elem_Type::u8;
+        return static_cast<Elem_Type>(static_cast<std::uint8_t>(first) + log_size);
+    }
+}
+
+inline constexpr char matrix_file_magic[4] = {'Y', 'L', 'M', 'X'};
+inline constexpr std::uint32_t matrix_file_byte_order = 0x01020304;
+inline constexpr std::uint16_t matrix_file_version = 1;
+
+} // namespace detail
+
+template<typename T>
+inline constexpr Elem_Type elem_type_v = detail::elem_type_of<T>();
+
+struct Matrix_File_Header final
+{
+    char magic[4];
+    std::uint32_t byte_order;  // 0x01020304 as written by the host which made the file
+    std::uint16_t version;
+    Elem_Type elem_type;
+    std::uint8_t elem_size;
+    std::uint32_t reserved;
+    std::uint64_t n_rows;
+    std::uint64_t n_cols;
+    std::uint64_t stride;      // in elements
+    std::uint64_t data_offset; // in bytes from the beginning of the file
+    std::uint8_t padding[16];
+};
+
+static_assert(sizeof(Matrix_File_Header) == 64 && std::is_trivially_copyable_v<Matrix_File_Header>);
+
+// Writes the matrix or the expression in the binary format. Rows of a matrix are written
+// as they are stored, padding included; other expressions are written without padding.
+template<Matrix_Expression E>
+void write_binary(std::ostream &os, const E &expr)
+{
+    using value_type = expr_value_t<E>;
+
+    const std::size_t n_rows = expr.n_rows();
+    const std::size_t n_cols = expr.n_cols();
+    std::size_t stride = n_cols;
+    if constexpr (is_matrix_v<E>)
+        stride = expr.stride();
+
+    Matrix_File_Header header{};
+    std::memcpy(header.magic, detail::matrix_file_magic, sizeof(header.magic));
+    header.byte_order = detail::matrix_file_byte_order;
+    header.version = detail::matrix_file_version;
+    header.elem_type = elem_type_v<value_type>;
+    header.elem_size = sizeof(value_type);
+    header.n_rows = n_rows;
+    header.n_cols = n_cols;
+    header.stride = stride;
+    header.data_offset = sizeof(Matrix_File_Header);
+
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if constexpr (is_matrix_v<E>)
+        os.write(reinterpret_cast<const char *>(expr.data()),
+                 n_rows * stride * sizeof(value_type));
+    else
+    {
+        std::vector<value_type> row(n_cols);
+        for (std::size_t i = 0; i != n_rows; ++i)
+        {
+            for (std::size_t j = 0; j != n_cols; ++j)
+                row[j] = detail::element(expr, i, j);
+            os.write(reinterpret_cast<const char *>(row.data()), n_cols * sizeof(value_type));
+        }
+    }
+
+    if (!os)
+        throw std::runtime_error{"Writing a matrix file failed"};
+}
+
+// Read-only memory mapping of a binary matrix file. The header is validated on construction;
+// view<T>() wraps the mapped elements without copying them.
+class Matrix_File final
+{
+public:
+
+    explicit Matrix_File(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw Bad_Matrix_File{"cannot open " + path};
+
+        try
+        {
+            map(fd);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+
+        ::close(fd);
+    }
+
+    // Maps a file which is open for reading, e.g. standard input redirected from a file.
+    // The descriptor isn't closed and may be closed right after the construction.
+    explicit Matrix_File(int fd) { map(fd); }
+
+    Matrix_File(const Matrix_File &rhs) = delete;
+    Matrix_File &operator=(const Matrix_File &rhs) = delete;
+
+    Matrix_File(Matrix_File &&rhs) noexcept
+        : address_{std::exchange(rhs.address_, nullptr)},
+          length_{std::exchange(rhs.length_, 0)},
+          header_{rhs.header_} {}
+
+    Matrix_File &operator=(Matrix_File &&rhs) noexcept
+    {
+        std::swap(address_, rhs.address_);
+        std::swap(length_, rhs.length_);
+        std::swap(header_, rhs.header_);
+        return *this;
+    }
+
+    ~Matrix_File()
+    {
+        if (address_)
+            ::munmap(address_, length_);
+    }
+
+    const Matrix_File_Header &header() const noexcept { return header_; }
+
+    Elem_Type elem_type() const noexcept { return header_.elem_type; }
+    std::size_t n_rows() const noexcept { return header_.n_rows; }
+    std::size_t n_cols() const noexcept { return header_.n_cols; }
+    std::size_t stride() const noexcept { return header_.stride; }
+
+    template<typename T>
+    Const_Matrix_View<T> view() const
+    {
+        if (header_.elem_type != elem_type_v<T>)
+            throw Bad_Matrix_File{"the type of elements differs from the requested one"};
+
+        const auto data = static_cast<const char *>(address_) + header_.data_offset;
+        return {reinterpret_cast<const T *>(data), n_rows(), n_cols(), stride()};
+    }
+
+private:
+
+    void map(int fd)
+    {
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) == -1 || !S_ISREG(file_stat.st_mode))
+            throw Bad_Matrix_File{"only regular files can be mapped"};
+
+        const auto file_size = static_cast<std::size_t>(file_stat.st_size);
+        if (file_size < sizeof(Matrix_File_Header))
+            throw Bad_Matrix_File{"the file is too short to have a header"};
+
+        // The header is checked before the mapping, so rejected files leave nothing mapped
+        Matrix_File_Header header;
+        if (::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+            throw Bad_Matrix_File{"cannot read the header"};
+        validate(header, file_size);
+
+        void *address = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+            throw Bad_Matrix_File{"mmap failed"};
+
+        address_ = address;
+        length_ = file_size;
+        header_ = header;
+
+        // Elements are usually read once from the first to the last
+        ::madvise(address_, length_, MADV_SEQUENTIAL);
+    }
+
+    static void validate(const Matrix_File_Header &header, std::size_t length)
+    {
+        if (std::memcmp(header.magic, detail::matrix_file_magic, sizeof(header.magic)) != 0)
+            throw Bad_Matrix_File{"no magic number"};
+        if (header.byte_order != detail::matrix_file_byte_order)
+            throw Bad_Matrix_File{"the file was written with a different byte order"};
+        if (header.version != detail::matrix_file_version)
+            throw Bad_Matrix_File{"unsupported version " + std::to_string(header.version)};
+
+        const auto elem_size = element_size(header.elem_type);
+        if (elem_size == 0 || elem_size != header.elem_size)
+            throw Bad_Matrix_File{"unknown type of elements"};
+        if (header.stride < header.n_cols)
+            throw Bad_Matrix_File{"the stride is less than the number of columns"};
+        if (header.data_offset < sizeof(Matrix_File_Header) || header.data_offset % elem_size != 0 ||
+            header.data_offset > length)
+            throw Bad_Matrix_File{"invalid offset of the elements"};
+
+        // n_rows * stride * elem_size mustn't overflow before it's compared with the length
+        const auto max_elems = (length - header.data_offset) / elem_size;
+        if (header.n_rows != 0 && header.stride > max_elems / header.n_rows)
+            throw Bad_Matrix_File{"the file is too short for the declared sizes"};
+    }
+
+    static std::size_t element_size(Elem_Type type) noexcept
+    {
+        switch (type)
+        {
+            case Elem_Type::i8: case Elem_Type::u8:
+                return 1;
+            case Elem_Type::i16: case Elem_Type::u16:
+                return 2;
+            case Elem_Type::i32: case Elem_Type::u32: case Elem_Type::f32:
+                return 4;
+            case Elem_Type::i64: case Elem_Type::u64: case Elem_Type::f64:
+                return 8;
+        }
+        return 0;
+    }
+
+    void *address_ = nullptr;
+    std::size_t length_ = 0;
+    Matrix_File_Header header_{};
+};
+
+} // namespace yLab
+
+#endif // INCLUDE_MATRIX_FILE_HPP
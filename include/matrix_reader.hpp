@@ -0,0 +1,170 @@
+#ifndef INCLUDE_MATRIX_READER_HPP
+#define INCLUDE_MATRIX_READER_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "matrix.hpp"
+
+namespace yLab
+{
+
+struct Bad_Matrix_Input final : public std::runtime_error
+{
+    explicit Bad_Matrix_Input(const std::string &what) : std::runtime_error{what} {};
+};
+
+// Parser of matrices in text form. Input is read in large chunks and numbers are converted
+// by std::from_chars, so neither locales nor formatted extraction of single elements
+// are involved. Numbers are separated by whitespace; a leading '+' is allowed.
+// The reader reads ahead of the last parsed number, so all matrices of a stream
+// should be read by the same reader.
+class Matrix_Reader final
+{
+public:
+
+    using size_type = std::size_t;
+
+    static constexpr size_type default_chunk_size = size_type{1} << 16;
+
+    explicit Matrix_Reader(std::istream &is, size_type chunk_size = default_chunk_size)
+        : is_{is}, buffer_(std::max(chunk_size, size_type{1})) {}
+
+    Matrix_Reader(const Matrix_Reader &rhs) = delete;
+    Matrix_Reader &operator=(const Matrix_Reader &rhs) = delete;
+
+    // Parses the next number into value. Returns false if there are no more numbers.
+    // Throws Bad_Matrix_Input if the next word isn't a number of type T.
+    template<typename T>
+    requires std::is_arithmetic_v<T>
+    bool next(T &value)
+    {
+        for (;;)
+        {
+            pos_ = std::find_if_not(pos_, end_, is_space);
+            if (pos_ == end_)
+            {
+                if (!fill())
+                    return false;
+                continue;
+            }
+
+            // The number may continue in the next chunk
+            const auto token_end = std::find_if(pos_, end_, is_space);
+            if (token_end == end_ && !eof_)
+            {
+                fill();
+                continue;
+            }
+
+            parse(pos_, token_end, value);
+            pos_ = token_end;
+            return true;
+        }
+    }
+
+    // Reads n_rows x n_cols elements row by row straight into the storage of the matrix
+    template<typename T, typename Allocator = std::allocator<T>>
+    Matrix<T, Allocator> read(size_type n_rows, size_type n_cols, const Allocator &alloc = Allocator{})
+    {
+        Matrix<T, Allocator> matrix{n_rows, n_cols, T{}, alloc};
+
+        for (size_type i = 0; i != n_rows; ++i)
+        {
+            T *row = matrix.data() + i * matrix.stride();
+            for (size_type j = 0; j != n_cols; ++j)
+                if (!next(row[j]))
+                    throw Bad_Matrix_Input{"unexpected end of input: " + std::to_string(i * n_cols + j) +
+                                           " of " + std::to_string(n_rows * n_cols) + " elements read"};
+        }
+
+        return matrix;
+    }
+
+    // Reads size N and then N x N elements of a square matrix
+    template<typename T, typename Allocator = std::allocator<T>>
+    Matrix<T, Allocator> read(const Allocator &alloc = Allocator{})
+    {
+        size_type size;
+        if (!next(size))
+            throw Bad_Matrix_Input{"reading size of matrix failed"};
+
+        return read<T, Allocator>(size, size, alloc);
+    }
+
+private:
+
+    using Iterator = std::vector<char>::iterator;
+
+    static bool is_space(char c) noexcept
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    template<typename T>
+    static void parse(Iterator first, Iterator last, T &value)
+    {
+        const char *begin = &*first;
+        const char *end = begin + (last - first);
+
+        if (*begin == '+' && end - begin > 1 && begin[1] != '-')
+            ++begin;
+
+        const auto [ptr, ec] = std::from_chars(begin, end, value);
+        if (ec != std::errc{} || ptr != end)
+            throw Bad_Matrix_Input{"invalid number \"" + std::string(first, last) + "\""};
+    }
+
+    // Moves the unparsed tail of the buffer to its beginning and reads the next chunk after it.
+    // The buffer grows if a single word doesn't fit in it. Returns false at the end of input.
+    bool fill()
+    {
+        const auto tail = end_ - pos_;
+        if (pos_ != buffer_.begin())
+            std::copy(pos_, end_, buffer_.begin());
+
+        if (static_cast<size_type>(tail) == buffer_.size())
+            buffer_.resize(2 * buffer_.size());
+
+        pos_ = buffer_.begin();
+        end_ = pos_ + tail;
+
+        if (eof_)
+            return false;
+
+        is_.read(&*end_, buffer_.end() - end_);
+        const auto count = is_.gcount();
+        end_ += count;
+
+        if (count == 0 || is_.eof())
+            eof_ = true;
+
+        return count != 0;
+    }
+
+    std::istream &is_;
+    std::vector<char> buffer_;
+    Iterator pos_ = buffer_.begin();
+    Iterator end_ = buffer_.begin();
+    bool eof_ = false;
+};
+
+// Reads size N and then N x N elements of a square matrix from is
+template<typename T, typename Allocator = std::allocator<T>>
+Matrix<T, Allocator> read_matrix(std::istream &is, const Allocator &alloc = Allocator{})
+{
+    Matrix_Reader reader{is};
+    return reader.read<T, Allocator>(alloc);
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_MATRIX_READER_HPP
@@ -0,0 +1,234 @@
+#ifndef INCLUDE_MATRIX_VIEW_HPP
+#define INCLUDE_MATRIX_VIEW_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "matrix_expr.hpp"
+
+namespace yLab
+{
+
+struct Undef_Block final : public std::out_of_range
+{
+    Undef_Block() : std::out_of_range{"The block is out of the bounds of the matrix"} {};
+};
+
+struct Undef_Assignment final : public std::invalid_argument
+{
+    Undef_Assignment()
+        : std::invalid_argument{"Assignment to a view of different sizes is not defined"} {};
+};
+
+// Defined in matrix.hpp
+struct Undef_Sum;
+struct Undef_Diff;
+
+template<typename T>
+requires std::is_arithmetic_v<T>
+class Matrix_View;
+
+template<typename T>
+using Const_Matrix_View = Matrix_View<const T>;
+
+namespace detail
+{
+
+template<typename T>
+struct is_expr_node<Matrix_View<T>> : std::true_type {};
+
+} // namespace detail
+
+// Non-owning view of a matrix: element (i, j) is data()[i * row_stride() + j * col_stride()].
+// Blocks, ranges of rows or columns and transposed views of matrices and other views are
+// made in O(1) without copying. Views are expressions, so they can be operands of arithmetic
+// operators, product() and dump(). Matrix_View<const T> is read-only.
+// Like pointers, views don't keep the matrix alive.
+template<typename T>
+requires std::is_arithmetic_v<T>
+class Matrix_View final
+{
+    template<typename Ptr_T>
+    struct Proxy_Row final
+    {
+        using Data_T = std::remove_pointer_t<Ptr_T>;
+
+        Ptr_T row_;
+        std::size_t col_stride_;
+        Data_T &operator[](std::size_t j) const { return row_[j * col_stride_]; }
+    };
+
+public:
+
+    using value_type = std::remove_const_t<T>;
+    using size_type = std::size_t;
+    using pointer = T *;
+    using reference = T &;
+
+    Matrix_View(pointer data, size_type n_rows, size_type n_cols,
+                size_type row_stride, size_type col_stride = 1) noexcept
+        : data_{data}, n_rows_{n_rows}, n_cols_{n_cols},
+          row_stride_{row_stride}, col_stride_{col_stride} {}
+
+    // Mutable views convert to read-only ones
+    template<typename U>
+    requires std::is_same_v<const U, T>
+    Matrix_View(const Matrix_View<U> &rhs) noexcept
+        : Matrix_View(rhs.data(), rhs.n_rows(), rhs.n_cols(), rhs.row_stride(), rhs.col_stride()) {}
+
+    // Fields access
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    pointer data() const noexcept { return data_; }
+
+    size_type n_rows() const noexcept { return n_rows_; }
+    size_type n_cols() const noexcept { return n_cols_; }
+    size_type row_stride() const noexcept { return row_stride_; }
+    size_type col_stride() const noexcept { return col_stride_; }
+
+    bool is_square() const noexcept { return n_rows_ == n_cols_; }
+
+    detail::Layout<value_type> layout() const noexcept
+    {
+        return {data_, n_rows_, n_cols_, row_stride_, col_stride_};
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Elements access
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    Proxy_Row<pointer> operator[](size_type row_i) const
+    {
+        return Proxy_Row<pointer>{data_ + row_i * row_stride_, col_stride_};
+    }
+
+    reference operator()(size_type i, size_type j) const
+    {
+        return data_[i * row_stride_ + j * col_stride_];
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Subviews
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // height x width block with the top left corner at (row_i, col_i)
+    Matrix_View block(size_type row_i, size_type col_i, size_type height, size_type width) const
+    {
+        if (row_i > n_rows_ || height > n_rows_ - row_i ||
+            col_i > n_cols_ || width > n_cols_ - col_i)
+            throw Undef_Block{};
+
+        return Matrix_View{data_ + row_i * row_stride_ + col_i * col_stride_, height, width,
+                           row_stride_, col_stride_};
+    }
+
+    // Rows [first, last)
+    Matrix_View row_range(size_type first, size_type last) const
+    {
+        if (first > last)
+            throw Undef_Block{};
+        return block(first, 0, last - first, n_cols_);
+    }
+
+    // Columns [first, last)
+    Matrix_View col_range(size_type first, size_type last) const
+    {
+        if (first > last)
+            throw Undef_Block{};
+        return block(0, first, n_rows_, last - first);
+    }
+
+    Matrix_View transposed() const noexcept
+    {
+        return Matrix_View{data_, n_cols_, n_rows_, col_stride_, row_stride_};
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Defined in matrix.hpp
+    value_type determinant() const;
+
+    // Expression interface
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    template<typename M>
+    M *owned_matrix() noexcept { return nullptr; }
+
+    bool aliases(const detail::Layout<value_type> &dst) const noexcept
+    {
+        return detail::may_alias(layout(), dst);
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Modifiers of the viewed elements. Copying a view rebinds it like a pointer,
+    // so assignment of elements has a name of its own.
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    template<Matrix_Expression E>
+    requires (!std::is_const_v<T> && std::is_same_v<expr_value_t<E>, value_type>)
+    const Matrix_View &assign(const E &expr) const
+    {
+        return update<Undef_Assignment>(expr,
+                                        [](value_type &elem, const value_type &value){ elem = value; });
+    }
+
+    template<Matrix_Expression E>
+    requires (!std::is_const_v<T> && std::is_same_v<expr_value_t<E>, value_type>)
+    const Matrix_View &operator+=(const E &expr) const
+    {
+        return update<Undef_Sum>(expr,
+                                 [](value_type &elem, const value_type &value){ elem += value; });
+    }
+
+    template<Matrix_Expression E>
+    requires (!std::is_const_v<T> && std::is_same_v<expr_value_t<E>, value_type>)
+    const Matrix_View &operator-=(const E &expr) const
+    {
+        return update<Undef_Diff>(expr,
+                                  [](value_type &elem, const value_type &value){ elem -= value; });
+    }
+
+    const Matrix_View &operator*=(const value_type &value) const requires (!std::is_const_v<T>)
+    {
+        for_each([&value](value_type &elem){ elem *= value; });
+        return *this;
+    }
+
+    const Matrix_View &operator/=(const value_type &value) const requires (!std::is_const_v<T>)
+    {
+        for_each([&value](value_type &elem){ elem /= value; });
+        return *this;
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+private:
+
+    template<typename F>
+    void for_each(F func) const
+    {
+        for (size_type i = 0; i != n_rows_; ++i)
+            for (size_type j = 0; j != n_cols_; ++j)
+                func((*this)(i, j));
+    }
+
+    // func(elem, value) for every element and the value of the expression at its position.
+    // Throws Error if the sizes differ. Defined in matrix.hpp.
+    template<typename Error, typename E, typename F>
+    const Matrix_View &update(const E &expr, F func) const;
+
+    T *data_;
+    size_type n_rows_;
+    size_type n_cols_;
+    size_type row_stride_;
+    size_type col_stride_;
+};
+
+} // namespace yLab
+
+#endif // INCLUDE_MATRIX_VIEW_HPP
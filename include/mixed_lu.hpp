@@ -0,0 +1,268 @@
+#ifndef INCLUDE_MIXED_LU_HPP
+#define INCLUDE_MIXED_LU_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lu.hpp"
+#include "lu_kernel.hpp"
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+#include "tiled_lu.hpp"
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// The type the factorization of Mixed_LU<T> is done in
+template<typename T>
+struct Lower_Precision {};
+
+template<>
+struct Lower_Precision<double> { using type = float; };
+
+template<>
+struct Lower_Precision<long double> { using type = double; };
+
+template<typename T>
+using lower_precision_t = typename Lower_Precision<T>::type;
+
+// Refinement gives up after that many steps, as LAPACK dsgesv does
+inline constexpr std::size_t refinement_max_steps = 30;
+
+// Refinement is considered stalled if a step doesn't reduce the residual by that factor
+inline constexpr double refinement_stall_ratio = 0.5;
+
+// Sum of x[k] * y[k] in T. Four partial sums break the dependency chain of additions,
+// which bounds a single sum by the latency of an addition rather than by the throughput.
+template<typename T, typename U>
+T dot_product(std::size_t n, const U *x, const T *y) noexcept
+{
+    T sums[4]{};
+
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+        for (std::size_t lane = 0; lane != 4; ++lane)
+            sums[lane] += x[k + lane] * y[k + lane];
+    for (; k != n; ++k)
+        sums[0] += x[k] * y[k];
+
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// Solves L * U * x = b in place for lower precision factors of lu_decompose() and x in
+// higher precision, which the dot products are accumulated in. On entry x holds P * b.
+template<typename T, typename Low_T>
+void mixed_lu_solve(std::size_t n, const Low_T *a, std::size_t lda, const std::size_t *rows, T *x)
+{
+    for (std::size_t i = 1; i < n; ++i)
+        x[i] -= dot_product(i, a + rows[i] * lda, x);
+
+    for (std::size_t i = n; i-- != 0;)
+    {
+        const Low_T *u_row = a + rows[i] * lda;
+        x[i] = (x[i] - dot_product(n - i - 1, u_row + i + 1, x + i + 1)) / u_row[i];
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+struct Refined_Solution final
+{
+    std::vector<T> solution;
+    std::size_t n_steps;    // refinement steps after the first solve
+    bool fell_back;         // refinement stalled, and the system was solved in T
+};
+
+// Mixed precision LU decomposition: P * A = L * U is computed in lower precision (float for
+// double), which halves the memory traffic of the O(n^3) part and doubles the number of
+// elements per SIMD vector. solve() restores full precision by iterative refinement:
+// the residual r = b - A * x is computed in T, and the correction solves L * U * d = P * r
+// with the lower precision factors, O(n^2) per step. Every step gains about as many digits
+// as the lower precision has over log10 of the condition number, so well-conditioned systems
+// need a few steps; if the residual stops decreasing, the system is solved by LU
+// decomposition in T.
+//
+// determinant() comes from the lower precision factors, so its relative error is about
+// n * epsilon of the lower precision times the condition number. The original matrix is
+// kept for the residuals.
+template<typename T, typename Allocator>
+class Mixed_LU final
+{
+    static_assert(std::is_floating_point_v<T>, "LU decomposition requires a floating-point type");
+    static_assert(requires { typename detail::lower_precision_t<T>; },
+                  "Mixed precision LU decomposition requires double or long double");
+
+    using Low_T = detail::lower_precision_t<T>;
+    using Low_Alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Low_T>;
+    using Size_Alloc =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>;
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    using matrix_type = Matrix<T, Allocator>;
+    using low_matrix_type = Matrix<Low_T, Low_Alloc>;
+    using allocator_type = Allocator;
+
+    explicit Mixed_LU(const matrix_type &matrix)
+        : matrix_{matrix, matrix.get_allocator()},
+          factors_{matrix.n_rows(), matrix.n_cols(), Low_T{}, Low_Alloc{matrix.get_allocator()}},
+          rows_(matrix.n_rows(), Size_Alloc{matrix.get_allocator()}),
+          perm_(matrix.n_rows(), Size_Alloc{matrix.get_allocator()})
+    {
+        if (!matrix.is_square())
+            throw Undef_LU{};
+
+        // Elements which don't fit into the lower precision leave refinement nothing to start from
+        bool fits = true;
+        for (size_type i = 0; i != size(); ++i)
+        {
+            const T *row = matrix_.data() + i * matrix_.stride();
+            Low_T *low_row = factors_.data() + i * factors_.stride();
+
+            T row_norm{};
+            for (size_type j = 0; j != size(); ++j)
+            {
+                fits = fits && std::abs(row[j]) <= std::numeric_limits<Low_T>::max();
+                low_row[j] = static_cast<Low_T>(row[j]);
+                row_norm += std::abs(row[j]);
+            }
+            norm_ = std::max(norm_, row_norm);
+        }
+
+        if (!fits)
+        {
+            sign_ = 0;
+            return;
+        }
+
+        // Large matrices are decomposed by tiled LU on all cores, as in Matrix::determinant().
+        // It swaps rows physically, so the factors are addressed directly, and the permutation
+        // of the right-hand side is composed of the swaps.
+        if (size() >= detail::tiled_lu_threshold)
+        {
+            std::vector<size_type, Size_Alloc> ipiv(size(), Size_Alloc{get_allocator()});
+            sign_ = detail::tiled_lu_decompose(Thread_Pool::default_pool(), size(),
+                                               factors_.data(), factors_.stride(), ipiv.data());
+
+            std::iota(rows_.begin(), rows_.end(), size_type{0});
+            std::iota(perm_.begin(), perm_.end(), size_type{0});
+            for (size_type i = 0; i != size(); ++i)
+                std::swap(perm_[i], perm_[ipiv[i]]);
+        }
+        else
+        {
+            sign_ = detail::lu_decompose(size(), factors_.data(), factors_.stride(), rows_.data());
+            perm_ = rows_;
+        }
+    }
+
+    size_type size() const noexcept { return matrix_.n_rows(); }
+
+    // Whether the lower precision factors are singular: solve() falls back to T then
+    bool is_singular() const noexcept { return sign_ == 0; }
+
+    allocator_type get_allocator() const noexcept { return matrix_.get_allocator(); }
+
+    value_type determinant() const
+    {
+        if (is_singular())
+            return LU<T, Allocator>{matrix_}.determinant();
+
+        // The product is accumulated in T, as it overflows the lower precision much sooner
+        value_type determinant{1};
+        for (size_type i = 0; i != size(); ++i)
+            determinant *= factors_.data()[rows_[i] * factors_.stride() + i];
+        if (sign_ < 0)
+            determinant = -determinant;
+
+        if (yLab::cmp::are_equal(determinant, value_type{}))
+            return value_type{};
+        return determinant;
+    }
+
+    // Solves A * x = b. Refinement stops when ||b - A * x|| <= ||x|| * ||A|| * epsilon * sqrt(n)
+    // in the max-norm, which is the criterion of LAPACK dsgesv.
+    Refined_Solution<T> solve(const std::vector<T> &rhs) const
+    {
+        if (rhs.size() != size())
+            throw Undef_Solve{};
+
+        if (is_singular())
+            return {LU<T, Allocator>{matrix_}.solve(rhs), 0, true};
+
+        const auto tolerance = norm_ * std::numeric_limits<T>::epsilon() *
+                               std::sqrt(static_cast<T>(size()));
+
+        std::vector<T> solution(size());
+        std::vector<T> residual = rhs;
+        std::vector<T> correction(size());
+
+        T previous_norm = std::numeric_limits<T>::infinity();
+        for (size_type step = 0; step != detail::refinement_max_steps + 1; ++step)
+        {
+            // x += (L * U)^-1 * P * r
+            for (size_type i = 0; i != size(); ++i)
+                correction[i] = residual[perm_[i]];
+            detail::mixed_lu_solve(size(), factors_.data(), factors_.stride(), rows_.data(),
+                                   correction.data());
+            for (size_type i = 0; i != size(); ++i)
+                solution[i] += correction[i];
+
+            // r = b - A * x
+            T residual_norm{}, solution_norm{};
+            for (size_type i = 0; i != size(); ++i)
+            {
+                const T *row = matrix_.data() + i * matrix_.stride();
+                residual[i] = rhs[i] - detail::dot_product(size(), row, solution.data());
+
+                residual_norm = std::max(residual_norm, std::abs(residual[i]));
+                solution_norm = std::max(solution_norm, std::abs(solution[i]));
+            }
+
+            if (residual_norm <= solution_norm * tolerance)
+                return {std::move(solution), step, false};
+
+            // NaN compares false, so it stalls as well
+            if (!(residual_norm < detail::refinement_stall_ratio * previous_norm))
+                return {LU<T, Allocator>{matrix_}.solve(rhs), step, true};
+
+            previous_norm = residual_norm;
+        }
+
+        return {LU<T, Allocator>{matrix_}.solve(rhs), detail::refinement_max_steps, true};
+    }
+
+private:
+
+    matrix_type matrix_;
+    low_matrix_type factors_;
+    std::vector<size_type, Size_Alloc> rows_;   // logical row i of the factors is rows_[i]
+    std::vector<size_type, Size_Alloc> perm_;   // row i of P * A is row perm_[i] of A
+    value_type norm_{};                          // ||A|| in the max-norm (largest row sum)
+    int sign_;
+};
+
+template<typename T, typename Allocator>
+requires std::is_arithmetic_v<T>
+Mixed_LU<T, Allocator> Matrix<T, Allocator>::mixed_lu() const requires std::is_floating_point_v<T>
+{
+    return Mixed_LU<T, Allocator>{*this};
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_MIXED_LU_HPP
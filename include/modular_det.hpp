@@ -0,0 +1,331 @@
+#ifndef INCLUDE_MODULAR_DET_HPP
+#define INCLUDE_MODULAR_DET_HPP
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+struct Det_Overflow final : public std::overflow_error
+{
+    Det_Overflow() : std::overflow_error{"The determinant doesn't fit into the element type"} {};
+};
+
+namespace detail
+{
+
+// Montgomery arithmetic modulo an odd number below 2^31. Residues are kept
+// in Montgomery form x * 2^32 mod p, so multiplication needs no division.
+class Montgomery final
+{
+public:
+
+    explicit Montgomery(std::uint32_t mod) noexcept : mod_{mod}
+    {
+        // Newton's iteration doubles the number of correct low bits of mod^(-1)
+        std::uint32_t inv = mod;
+        for (auto i = 0; i != 4; ++i)
+            inv *= 2 - mod * inv;
+        neg_inv_ = -inv;
+
+        r2_ = static_cast<std::uint32_t>((~std::uint64_t{0} % mod + 1) % mod);
+    }
+
+    std::uint32_t mod() const noexcept { return mod_; }
+
+    // t * 2^(-32) mod p for t < p * 2^32
+    std::uint32_t reduce(std::uint64_t t) const noexcept
+    {
+        const std::uint32_t m = static_cast<std::uint32_t>(t) * neg_inv_;
+        const auto u = static_cast<std::uint32_t>((t + std::uint64_t{m} * mod_) >> 32);
+        return (u >= mod_) ? u - mod_ : u;
+    }
+
+    std::uint32_t to_montgomery(std::uint32_t x) const noexcept { return reduce(std::uint64_t{x} * r2_); }
+    std::uint32_t from_montgomery(std::uint32_t x) const noexcept { return reduce(x); }
+
+    std::uint32_t mul(std::uint32_t a, std::uint32_t b) const noexcept
+    {
+        return reduce(std::uint64_t{a} * b);
+    }
+
+    std::uint32_t sub(std::uint32_t a, std::uint32_t b) const noexcept
+    {
+        return (a >= b) ? a - b : a + mod_ - b;
+    }
+
+    std::uint32_t pow(std::uint32_t base, std::uint32_t exp) const noexcept
+    {
+        std::uint32_t res = to_montgomery(1);
+        for (; exp; exp >>= 1, base = mul(base, base))
+            if (exp & 1)
+                res = mul(res, base);
+        return res;
+    }
+
+    // Multiplicative inverse by Fermat's little theorem: p must be prime
+    std::uint32_t inverse(std::uint32_t x) const noexcept { return pow(x, mod_ - 2); }
+
+private:
+
+    std::uint32_t mod_;
+    std::uint32_t neg_inv_;
+    std::uint32_t r2_; // 2^64 mod p
+};
+
+inline std::uint64_t pow_mod(std::uint64_t base, std::uint64_t exp, std::uint64_t mod) noexcept
+{
+    std::uint64_t res = 1;
+    for (base %= mod; exp; exp >>= 1, base = base * base % mod)
+        if (exp & 1)
+            res = res * base % mod;
+    return res;
+}
+
+// Deterministic Miller-Rabin test for n < 3'215'031'751
+inline bool is_prime(std::uint32_t n) noexcept
+{
+    if (n < 2)
+        return false;
+
+    for (std::uint32_t p : {2u, 3u, 5u, 7u})
+        if (n % p == 0)
+            return n == p;
+
+    std::uint32_t d = n - 1;
+    int s = 0;
+    for (; d % 2 == 0; d /= 2)
+        ++s;
+
+    for (std::uint64_t a : {2u, 3u, 5u, 7u})
+    {
+        std::uint64_t x = pow_mod(a, d, n);
+        if (x == 1 || x == n - 1)
+            continue;
+
+        bool is_witness = true;
+        for (int r = 1; r < s && is_witness; ++r)
+        {
+            x = x * x % n;
+            if (x == n - 1)
+                is_witness = false;
+        }
+
+        if (is_witness)
+            return false;
+    }
+
+    return true;
+}
+
+// The first count primes below 2^31 in descending order
+inline std::vector<std::uint32_t> modular_primes(std::size_t count)
+{
+    static std::mutex mutex;
+    static std::vector<std::uint32_t> primes;
+
+    std::lock_guard lock{mutex};
+
+    for (std::uint32_t candidate = primes.empty() ? (1u << 31) - 1 : primes.back() - 2;
+         primes.size() < count; candidate -= 2)
+    {
+        if (is_prime(candidate))
+            primes.push_back(candidate);
+    }
+
+    return {primes.begin(), primes.begin() + count};
+}
+
+// Every prime of modular_primes() is greater than 2^30
+inline constexpr double modular_prime_bits = 30.0;
+
+// log2 of Hadamard's bound on |det|: the product of Euclidean norms of the rows.
+// Returns -infinity if there is a zero row.
+template<typename T, typename Allocator>
+long double log2_hadamard_bound(const Matrix<T, Allocator> &matrix)
+{
+    long double log2_bound = 0;
+
+    for (std::size_t i = 0; i != matrix.n_rows(); ++i)
+    {
+        long double norm_2 = 0;
+        for (std::size_t j = 0; j != matrix.n_cols(); ++j)
+        {
+            const auto elem = static_cast<long double>(matrix[i][j]);
+            norm_2 += elem * elem;
+        }
+
+        if (norm_2 == 0)
+            return -INFINITY;
+        log2_bound += std::log2(norm_2) / 2;
+    }
+
+    return log2_bound;
+}
+
+// Determinant of the matrix modulo prime p by Gaussian elimination in Montgomery form
+template<std::signed_integral T, typename Allocator>
+std::uint32_t det_mod_prime(const Matrix<T, Allocator> &matrix, std::uint32_t p)
+{
+    const Montgomery mont{p};
+    const std::size_t n = matrix.n_rows();
+
+    std::vector<std::uint32_t> a(n * n);
+    for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+        {
+            auto residue = static_cast<long long>(matrix[i][j]) % static_cast<long long>(p);
+            if (residue < 0)
+                residue += p;
+            a[i * n + j] = mont.to_montgomery(static_cast<std::uint32_t>(residue));
+        }
+
+    std::uint32_t det = mont.to_montgomery(1);
+
+    for (std::size_t k = 0; k != n; ++k)
+    {
+        std::size_t pivot_i = k;
+        while (pivot_i != n && a[pivot_i * n + k] == 0)
+            ++pivot_i;
+
+        if (pivot_i == n)
+            return 0;
+
+        if (pivot_i != k)
+        {
+            std::swap_ranges(a.begin() + k * n + k, a.begin() + (k + 1) * n,
+                             a.begin() + pivot_i * n + k);
+            det = mont.sub(0, det);
+        }
+
+        const std::uint32_t *pivot_row = a.data() + k * n;
+        det = mont.mul(det, pivot_row[k]);
+        const std::uint32_t pivot_inv = mont.inverse(pivot_row[k]);
+
+        for (std::size_t i = k + 1; i != n; ++i)
+        {
+            std::uint32_t *row = a.data() + i * n;
+            if (row[k] == 0)
+                continue;
+
+            const std::uint32_t coeff = mont.mul(row[k], pivot_inv);
+            for (std::size_t j = k + 1; j != n; ++j)
+                row[j] = mont.sub(row[j], mont.mul(coeff, pivot_row[j]));
+        }
+    }
+
+    return mont.from_montgomery(det);
+}
+
+// Chinese remaindering by Garner's algorithm with digits in the symmetric range
+// [-(p - 1) / 2, (p - 1) / 2]: for odd moduli they represent exactly the integers
+// x with |x| <= (M - 1) / 2, where M is the product of all moduli.
+template<std::signed_integral T>
+T crt_reconstruct(const std::vector<std::uint32_t> &residues, const std::vector<std::uint32_t> &primes)
+{
+    const auto n_primes = primes.size();
+    std::vector<std::int64_t> digits(n_primes);
+
+    for (std::size_t i = 0; i != n_primes; ++i)
+    {
+        const std::uint64_t p = primes[i];
+
+        // Value of the digits found so far and the product of the previous primes, mod p
+        std::uint64_t value = 0;
+        std::uint64_t radix = 1;
+        for (std::size_t j = 0; j != i; ++j)
+        {
+            const auto signed_p = static_cast<std::int64_t>(p);
+            const auto digit = static_cast<std::uint64_t>((digits[j] % signed_p + signed_p) % signed_p);
+            value = (value + digit * radix) % p;
+            radix = radix * primes[j] % p;
+        }
+
+        const std::uint64_t diff = (residues[i] + p - value) % p;
+        const auto digit = static_cast<std::int64_t>(diff * pow_mod(radix, p - 2, p) % p);
+        digits[i] = (digit > static_cast<std::int64_t>(p / 2)) ? digit - static_cast<std::int64_t>(p)
+                                                               : digit;
+    }
+
+    // Horner's scheme: if the result fits into T, so does every partial sum
+    T result{};
+    for (std::size_t i = n_primes; i-- != 0;)
+    {
+        if (__builtin_mul_overflow(result, primes[i], &result) ||
+            __builtin_add_overflow(result, digits[i], &result))
+            throw Det_Overflow{};
+    }
+
+    return result;
+}
+
+// for_each_prime(n, func) must call func(i) for every i in [0, n)
+template<std::signed_integral T, typename Allocator, typename For_Each>
+T modular_determinant_impl(const Matrix<T, Allocator> &matrix, For_Each for_each_prime)
+{
+    if (!matrix.is_square())
+        throw Undef_Det{};
+    if (matrix.n_rows() == 0)
+        return T{1};
+
+    const long double log2_bound = log2_hadamard_bound(matrix);
+    if (log2_bound == -INFINITY)
+        return T{};
+
+    // One more bit for the sign and one prime to spare for rounding in the bound
+    const auto n_primes = static_cast<std::size_t>((log2_bound + 1) / modular_prime_bits) + 2;
+    const auto primes = modular_primes(n_primes);
+
+    std::vector<std::uint32_t> residues(n_primes);
+    for_each_prime(n_primes, [&](std::size_t i)
+    {
+        residues[i] = det_mod_prime(matrix, primes[i]);
+    });
+
+    return crt_reconstruct<T>(residues, primes);
+}
+
+} // namespace detail
+
+// Exact determinant of an integer matrix: it's computed modulo enough word-sized primes
+// for their product to exceed twice Hadamard's bound, and then recovered by the Chinese
+// Remainder Theorem. Intermediate values never grow, unlike in Bareiss algorithm.
+// Primes are independent of each other, so the parallel version spreads them over the pool.
+// Throws Det_Overflow if the determinant doesn't fit into T.
+template<std::signed_integral T, typename Allocator>
+T modular_determinant(const execution::Parallel_Policy &policy, const Matrix<T, Allocator> &matrix)
+{
+    return detail::modular_determinant_impl(matrix, [&policy](std::size_t n_primes, auto func)
+    {
+        policy.get_pool().parallel_for(n_primes, func);
+    });
+}
+
+template<std::signed_integral T, typename Allocator>
+T modular_determinant(execution::Sequenced_Policy, const Matrix<T, Allocator> &matrix)
+{
+    return detail::modular_determinant_impl(matrix, [](std::size_t n_primes, auto func)
+    {
+        for (std::size_t i = 0; i != n_primes; ++i)
+            func(i);
+    });
+}
+
+template<std::signed_integral T, typename Allocator>
+T modular_determinant(const Matrix<T, Allocator> &matrix)
+{
+    return modular_determinant(execution::par, matrix);
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_MODULAR_DET_HPP
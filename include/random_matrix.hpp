@@ -1,88 +1,93 @@
 #ifndef INCLUDE_RANDOM_MATRIX
 #define INCLUDE_RANDOM_MATRIX
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <random>
-#include <ostream>
-#include <iomanip>
-#include <algorithm>
 #include <type_traits>
 
+#include "matrix.hpp"
+
 namespace yLab
 {
 
-template<typename T>
-requires std::is_integral_v<T>
-struct Random_Matrix final
+namespace detail
 {
-    std::size_t size_;
-    std::vector<std::vector<T>> memory_;
 
-    Random_Matrix (std::size_t size, T det) : size_{size}, memory_(size)
-    {
-        for (auto i = 0; i != size_; ++i)
-            memory_[i].resize (size_);
+// SplitMix64 finalizer: consecutive inputs give unrelated outputs
+constexpr std::uint64_t split_mix (std::uint64_t x) noexcept
+{
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
 
-        memory_[0][0] = T{det};
-        for (auto i = 1; i != size_; ++i)
-            memory_[i][i] = T{1};
+// Rows of L in random_matrix() have up to that many elements below the diagonal
+inline constexpr std::size_t random_matrix_row_terms = 8;
 
-        std::random_device rd;
-        std::mt19937_64 gen{rd()};
+} // namespace detail
 
-        std::uniform_int_distribution<std::size_t> rows{0, size - 1};
-        std::uniform_int_distribution<T> mult{-static_cast<T>(size) / 2,
-                                               static_cast<T>(size) / 2};
+// Seed of the index-th matrix of a set generated from master_seed. Every matrix of the set
+// is reproducible on its own, whatever the order or the thread it's generated in.
+constexpr std::uint64_t random_matrix_seed (std::uint64_t master_seed, std::uint64_t index) noexcept
+{
+    return detail::split_mix (master_seed ^ detail::split_mix (index));
+}
 
-        auto n_shuffles = size * 2;
-        for (auto shuffle_i = 0; shuffle_i != n_shuffles; ++shuffle_i)
-            strings_transformation (rows (gen), rows (gen), mult (gen));
+// Random size x size matrix with determinant det: the product L * D * U of a random unit
+// lower triangular matrix L, D = diag(det, 1, ..., 1) and a random unit upper triangular
+// matrix U. Elements of U above the diagonal are from {-1, 0, 1}, and every row of L has up to
+// random_matrix_row_terms elements from {-1, 1} below the diagonal, so whatever the size,
+// |elements| <= (random_matrix_row_terms + 1) * max(|det|, 1). Elements are integers, so T may
+// be floating point too. It takes O(size^2) operations in the contiguous storage of the result.
+template<typename T, typename Allocator = std::allocator<T>, typename Generator>
+requires std::is_arithmetic_v<T>
+Matrix<T, Allocator> random_matrix (std::size_t size, T det, Generator &gen,
+                                    const Allocator &alloc = Allocator{})
+{
+    Matrix<T, Allocator> matrix {size, size, T{}, alloc};
+    if (size == 0)
+        return matrix;
 
-        for (auto shuffle_i = 0; shuffle_i != n_shuffles; ++shuffle_i)
-            columns_transformation (rows (gen), rows (gen), mult (gen));
-    }
+    const auto stride = matrix.stride();
+    T *data = matrix.data();
 
-    void strings_transformation (std::size_t row_1, std::size_t row_2, T mult)
+    // D * U
+    std::uniform_int_distribution<int> trit {-1, 1};
+    for (std::size_t i = 0; i != size; ++i)
     {
-        if (row_1 == row_2)
-            return;
-
-        for (auto j = 0; j != size_; ++j)
-            memory_[row_1][j] += memory_[row_2][j] * mult;
+        T *row = data + i * stride;
+        row[i] = T{1};
+        for (std::size_t j = i + 1; j != size; ++j)
+            row[j] = static_cast<T>(trit (gen));
     }
+    for (std::size_t j = 0; j != size; ++j)
+        data[j] *= det;
 
-    void columns_transformation (std::size_t col_1, std::size_t col_2, T mult)
+    // L * (D * U). Rows are updated from the last one, so the rows above are still those
+    // of D * U; row k of it is zero before column k.
+    std::uniform_int_distribution<int> sign {0, 1};
+    for (std::size_t i = size; i-- > 1;)
     {
-        if (col_1 == col_2)
-            return;
-
-        for (auto i = 0; i != size_; ++i)
-            memory_[i][col_1] += memory_[i][col_2] * mult;
-    }
-};
-
-template<typename T>
-void dump (std::ostream &os, const Random_Matrix<T> &matrix)
-{
-    os.setf (std::ios::left);
+        T *dst = data + i * stride;
+        std::uniform_int_distribution<std::size_t> above {0, i - 1};
 
-    for (auto i = 0, k = 1; i != matrix.size_; ++i)
-    {
-        for (auto j = 0; j != matrix.size_; ++j)
+        for (std::size_t term = 0; term != detail::random_matrix_row_terms; ++term)
         {
-            if (k++ % matrix.size_ == 0)
-                os << matrix.memory_[i][j] << std::endl;
+            const auto k = above (gen);
+            const T *src = data + k * stride;
+            if (sign (gen))
+                for (std::size_t j = k; j != size; ++j)
+                    dst[j] += src[j];
             else
-                os << std::setw(5) << matrix.memory_[i][j] << " ";
+                for (std::size_t j = k; j != size; ++j)
+                    dst[j] -= src[j];
         }
     }
-}
 
-template<typename T>
-std::ostream &operator<< (std::ostream &os, const Random_Matrix<T> &matrix)
-{
-    dump(os, matrix);
-    return os;
+    return matrix;
 }
 
 } // namespace yLab
@@ -0,0 +1,284 @@
+#ifndef INCLUDE_SIMD_HPP
+#define INCLUDE_SIMD_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace yLab
+{
+
+namespace detail
+{
+
+namespace simd
+{
+
+// Explicit SIMD kernels for row operations. Every kernel is written once over GCC vector
+// extensions and instantiated for 16-, 32- and 64-byte vectors inside functions compiled
+// for SSE2, AVX2 and AVX-512 respectively. The widest instruction set supported by the CPU
+// is chosen at run time, so a binary built for generic x86-64 still uses AVX-512 where
+// it's available.
+
+enum class Isa
+{
+    sse2,
+    avx2,
+    avx512
+};
+
+inline bool is_supported(Isa isa) noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    switch (isa)
+    {
+        case Isa::sse2:
+            return true;
+        case Isa::avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::avx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+    }
+    return false;
+#else
+    return isa == Isa::sse2;
+#endif
+}
+
+// The widest supported instruction set. YLAB_SIMD environment variable (sse2, avx2 or avx512)
+// may lower it, e.g. to compare hosts.
+inline Isa active_isa() noexcept
+{
+    static const Isa isa = []
+    {
+        Isa best = Isa::sse2;
+        for (auto candidate : {Isa::avx2, Isa::avx512})
+            if (is_supported(candidate))
+                best = candidate;
+
+        if (const char *env = std::getenv("YLAB_SIMD"))
+        {
+            const std::string_view name{env};
+            const Isa requested = (name == "avx512") ? Isa::avx512
+                                : (name == "avx2")   ? Isa::avx2
+                                                     : Isa::sse2;
+            if (requested < best)
+                best = requested;
+        }
+
+        return best;
+    }();
+
+    return isa;
+}
+
+template<typename T>
+inline constexpr bool is_vectorizable_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// Kernels. Vector loads and stores go through memcpy, so rows needn't be aligned.
+// Integer division has no SIMD instructions: the compiler splits it into scalar ones.
+//
+// The same call must give the same bits for every instruction set, so the project is built
+// with -ffp-contract=off: otherwise AVX2 and AVX-512 kernels would fuse y - alpha * x into FMA,
+// and SSE2 ones wouldn't.
+
+#define YLAB_SIMD_VECTOR(Width)                                                          \
+    typedef T Vec __attribute__((vector_size(Width)));                                   \
+    constexpr std::size_t n_lanes = Width / sizeof(T);
+
+// y[j] -= alpha * x[j]
+struct Sub_Scaled final
+{
+    template<std::size_t Width, typename T>
+    [[gnu::always_inline]] static inline void run(std::size_t n, T *y, const T *x, T alpha)
+    {
+        YLAB_SIMD_VECTOR(Width)
+
+        std::size_t j = 0;
+        for (; j + n_lanes <= n; j += n_lanes)
+        {
+            Vec vx, vy;
+            std::memcpy(&vx, x + j, sizeof(Vec));
+            std::memcpy(&vy, y + j, sizeof(Vec));
+            vy -= alpha * vx;
+            std::memcpy(y + j, &vy, sizeof(Vec));
+        }
+
+        for (; j != n; ++j)
+            y[j] -= alpha * x[j];
+    }
+};
+
+// y[j] = (y[j] * a - x[j] * b) / d: a step of Bareiss algorithm
+struct Bareiss_Update final
+{
+    template<std::size_t Width, typename T>
+    [[gnu::always_inline]] static inline void run(std::size_t n, T *y, const T *x, T a, T b, T d)
+    {
+        YLAB_SIMD_VECTOR(Width)
+
+        std::size_t j = 0;
+        for (; j + n_lanes <= n; j += n_lanes)
+        {
+            Vec vx, vy;
+            std::memcpy(&vx, x + j, sizeof(Vec));
+            std::memcpy(&vy, y + j, sizeof(Vec));
+            vy = (vy * a - vx * b) / d;
+            std::memcpy(y + j, &vy, sizeof(Vec));
+        }
+
+        for (; j != n; ++j)
+            y[j] = (y[j] * a - x[j] * b) / d;
+    }
+};
+
+enum class Op
+{
+    plus,
+    minus,
+    multiplies,
+    divides
+};
+
+// Vectors are passed by reference: passing them by value changes the ABI with the ISA
+template<Op op, typename U, typename V>
+[[gnu::always_inline]] inline void apply(U &u, const V &v)
+{
+    if constexpr (op == Op::plus)
+        u += v;
+    else if constexpr (op == Op::minus)
+        u -= v;
+    else if constexpr (op == Op::multiplies)
+        u *= v;
+    else
+        u /= v;
+}
+
+// y[j] = y[j] op x[j]
+template<Op op>
+struct Elementwise final
+{
+    template<std::size_t Width, typename T>
+    [[gnu::always_inline]] static inline void run(std::size_t n, T *y, const T *x)
+    {
+        YLAB_SIMD_VECTOR(Width)
+
+        std::size_t j = 0;
+        for (; j + n_lanes <= n; j += n_lanes)
+        {
+            Vec vx, vy;
+            std::memcpy(&vx, x + j, sizeof(Vec));
+            std::memcpy(&vy, y + j, sizeof(Vec));
+            apply<op>(vy, vx);
+            std::memcpy(y + j, &vy, sizeof(Vec));
+        }
+
+        for (; j != n; ++j)
+            apply<op>(y[j], x[j]);
+    }
+};
+
+// y[j] = y[j] op value
+template<Op op>
+struct Elementwise_Scalar final
+{
+    template<std::size_t Width, typename T>
+    [[gnu::always_inline]] static inline void run(std::size_t n, T *y, T value)
+    {
+        YLAB_SIMD_VECTOR(Width)
+
+        std::size_t j = 0;
+        for (; j + n_lanes <= n; j += n_lanes)
+        {
+            Vec vy;
+            std::memcpy(&vy, y + j, sizeof(Vec));
+            apply<op>(vy, value);
+            std::memcpy(y + j, &vy, sizeof(Vec));
+        }
+
+        for (; j != n; ++j)
+            apply<op>(y[j], value);
+    }
+};
+
+#undef YLAB_SIMD_VECTOR
+
+template<typename Kernel, typename... Args>
+void run_sse2(Args... args) { Kernel::template run<16>(args...); }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+template<typename Kernel, typename... Args>
+[[gnu::target("avx2,fma")]] void run_avx2(Args... args) { Kernel::template run<32>(args...); }
+
+template<typename Kernel, typename... Args>
+[[gnu::target("avx512f,avx512dq")]] void run_avx512(Args... args) { Kernel::template run<64>(args...); }
+
+#endif
+
+template<typename Kernel, typename... Args>
+void dispatch(Isa isa, Args... args)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    switch (isa)
+    {
+        case Isa::avx512:
+            run_avx512<Kernel>(args...);
+            return;
+        case Isa::avx2:
+            run_avx2<Kernel>(args...);
+            return;
+        case Isa::sse2:
+            break;
+    }
+#endif
+    run_sse2<Kernel>(args...);
+}
+
+template<typename T>
+void sub_scaled(std::size_t n, T *y, const T *x, T alpha, Isa isa = active_isa())
+{
+    dispatch<Sub_Scaled>(isa, n, y, x, alpha);
+}
+
+template<typename T>
+void bareiss_update(std::size_t n, T *y, const T *x, T a, T b, T d, Isa isa = active_isa())
+{
+    dispatch<Bareiss_Update>(isa, n, y, x, a, b, d);
+}
+
+template<typename T>
+void add(std::size_t n, T *y, const T *x, Isa isa = active_isa())
+{
+    dispatch<Elementwise<Op::plus>>(isa, n, y, x);
+}
+
+template<typename T>
+void subtract(std::size_t n, T *y, const T *x, Isa isa = active_isa())
+{
+    dispatch<Elementwise<Op::minus>>(isa, n, y, x);
+}
+
+template<typename T>
+void multiply(std::size_t n, T *y, T value, Isa isa = active_isa())
+{
+    dispatch<Elementwise_Scalar<Op::multiplies>>(isa, n, y, value);
+}
+
+template<typename T>
+void divide(std::size_t n, T *y, T value, Isa isa = active_isa())
+{
+    dispatch<Elementwise_Scalar<Op::divides>>(isa, n, y, value);
+}
+
+} // namespace simd
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_SIMD_HPP
@@ -0,0 +1,381 @@
+#ifndef INCLUDE_SPARSE_LU_HPP
+#define INCLUDE_SPARSE_LU_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "floating_point_comparison.hpp"
+#include "lu.hpp"
+#include "sparse_matrix.hpp"
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// Minimum degree ordering of the graph of A + A^T, where A is n x n in a compressed format.
+// The vertex of the least degree is eliminated first, and its neighbours become a clique,
+// as they do in the factors. Elimination of a vertex costs the square of its degree, so for
+// the sparse matrices it's meant for the ordering is much cheaper than the factorization.
+// Returns the order of elimination.
+inline std::vector<std::size_t> minimum_degree_ordering(std::size_t n,
+                                                        std::span<const std::size_t> offsets,
+                                                        std::span<const std::size_t> indices)
+{
+    std::vector<std::vector<std::size_t>> adjacency(n);
+    for (std::size_t line = 0; line != n; ++line)
+        for (auto k = offsets[line]; k != offsets[line + 1]; ++k)
+            if (indices[k] != line)
+            {
+                adjacency[line].push_back(indices[k]);
+                adjacency[indices[k]].push_back(line);
+            }
+
+    for (auto &neighbours : adjacency)
+    {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    // Degrees change as vertices are eliminated: stale entries of the queue are skipped
+    using Entry = std::pair<std::size_t, std::size_t>; // {degree, vertex}
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (std::size_t v = 0; v != n; ++v)
+        queue.emplace(adjacency[v].size(), v);
+
+    std::vector<bool> eliminated(n);
+    std::vector<std::size_t> order;
+    order.reserve(n);
+
+    std::vector<std::size_t> merged;
+    while (!queue.empty())
+    {
+        const auto [degree, v] = queue.top();
+        queue.pop();
+        if (eliminated[v] || degree != adjacency[v].size())
+            continue;
+
+        eliminated[v] = true;
+        order.push_back(v);
+
+        const auto clique = std::move(adjacency[v]);
+        for (auto u : clique)
+        {
+            // adjacency[u] = adjacency[u] + clique - {u, v}; both are sorted
+            merged.clear();
+            std::set_union(adjacency[u].begin(), adjacency[u].end(), clique.begin(), clique.end(),
+                           std::back_inserter(merged));
+            std::erase_if(merged, [&](std::size_t w){ return w == u || w == v; });
+
+            adjacency[u].swap(merged);
+            queue.emplace(adjacency[u].size(), u);
+        }
+    }
+
+    return order;
+}
+
+// Parity of a permutation: +1 or -1
+inline int permutation_sign(std::span<const std::size_t> perm)
+{
+    std::vector<bool> visited(perm.size());
+    int sign = 1;
+
+    for (std::size_t first = 0; first != perm.size(); ++first)
+    {
+        if (visited[first])
+            continue;
+
+        std::size_t length = 0;
+        for (auto i = first; !visited[i]; i = perm[i])
+        {
+            visited[i] = true;
+            ++length;
+        }
+
+        if (length % 2 == 0)
+            sign = -sign;
+    }
+
+    return sign;
+}
+
+} // namespace detail
+
+// Sparse LU decomposition P * A * Q = L * U by Gilbert-Peierls left-looking algorithm.
+// Q is the minimum degree ordering of A + A^T, which limits the fill-in. Column k of the factors
+// is computed by a sparse triangular solve with L, whose nonzero pattern is found by
+// a depth-first search in the graph of L first, so the time is proportional to the number
+// of floating point operations rather than to n^2 per column.
+//
+// Pivots are chosen by threshold partial pivoting: the diagonal entry of the ordered matrix
+// is kept unless it's less than pivot_threshold times the largest candidate. That preserves
+// the ordering for diagonally dominant and symmetric positive definite matrices.
+template<typename T>
+class Sparse_LU final
+{
+    static_assert(std::is_floating_point_v<T>, "LU decomposition requires a floating-point type");
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr value_type pivot_threshold = 0.1;
+
+    template<Sparse_Layout Layout>
+    explicit Sparse_LU(const Sparse_Matrix<value_type, Layout> &matrix)
+    {
+        if (!matrix.is_square())
+            throw Undef_LU{};
+
+        // The factorization works on columns. CSR of A is CSC of A^T, and its decomposition
+        // gives the same determinant, but solve() needs the columns of A itself.
+        if constexpr (Layout == Sparse_Layout::csc)
+            factorize(matrix);
+        else
+            factorize(CSC_Matrix<value_type>{matrix});
+    }
+
+    size_type size() const noexcept { return col_perm_.size(); }
+
+    bool is_singular() const noexcept { return singular_; }
+
+    // Nonzeros of L and U including the diagonal of U
+    size_type nnz() const noexcept { return l_values_.size() + u_values_.size(); }
+
+    // Step k eliminates column col_permutation()[k] with pivot row row_permutation()[k]
+    const std::vector<size_type> &row_permutation() const noexcept { return row_perm_; }
+    const std::vector<size_type> &col_permutation() const noexcept { return col_perm_; }
+
+    value_type determinant() const
+    {
+        if (singular_)
+            return value_type{};
+
+        value_type determinant = detail::permutation_sign(row_perm_) *
+                                 detail::permutation_sign(col_perm_);
+        for (size_type k = 0; k != size(); ++k)
+            determinant *= u_values_[u_offsets_[k + 1] - 1];
+
+        if (yLab::cmp::are_equal(determinant, value_type{}))
+            return value_type{};
+        return determinant;
+    }
+
+    // Solves A * x = b
+    std::vector<value_type> solve(std::span<const value_type> rhs) const
+    {
+        if (rhs.size() != size())
+            throw Undef_Solve{};
+        if (singular_)
+            throw Singular_Matrix{};
+
+        // L * y = P * b: entries of L are indexed by rows of A
+        std::vector<value_type> b(rhs.begin(), rhs.end());
+        std::vector<value_type> y(size());
+        for (size_type k = 0; k != size(); ++k)
+        {
+            const auto y_k = y[k] = b[row_perm_[k]];
+            for (auto p = l_offsets_[k]; p != l_offsets_[k + 1]; ++p)
+                b[l_rows_[p]] -= l_values_[p] * y_k;
+        }
+
+        // U * z = y: entries of U are indexed by steps; the diagonal is last in its column
+        std::vector<value_type> solution(size());
+        for (size_type k = size(); k-- != 0;)
+        {
+            const auto z_k = y[k] / u_values_[u_offsets_[k + 1] - 1];
+            for (auto p = u_offsets_[k]; p != u_offsets_[k + 1] - 1; ++p)
+                y[u_rows_[p]] -= u_values_[p] * z_k;
+
+            solution[col_perm_[k]] = z_k;
+        }
+
+        return solution;
+    }
+
+private:
+
+    static constexpr auto unassigned = static_cast<size_type>(-1);
+
+    void factorize(const CSC_Matrix<value_type> &a)
+    {
+        const auto n = a.n_rows();
+        const auto a_offsets = a.offsets();
+        const auto a_rows = a.indices();
+        const auto a_values = a.values();
+
+        col_perm_ = detail::minimum_degree_ordering(n, a_offsets, a_rows);
+        row_perm_.assign(n, unassigned);
+
+        l_offsets_.assign(1, 0);
+        u_offsets_.assign(1, 0);
+
+        // pivot_step[i] is the step which chose row i as its pivot, if any
+        std::vector<size_type> pivot_step(n, unassigned);
+
+        std::vector<value_type> x(n);
+        std::vector<size_type> pattern;     // rows reached by column k in topological order
+        std::vector<size_type> mark(n, unassigned);
+        std::vector<std::pair<size_type, size_type>> stack; // {row, next entry of its column in L}
+
+        for (size_type k = 0; k != n; ++k)
+        {
+            const auto col = col_perm_[k];
+
+            // Symbolic step: rows of x = L^-1 * A(:, col) are the rows reachable from the pattern
+            // of A(:, col) in the graph of L. Reverse postorder of the DFS is topological.
+            pattern.clear();
+            for (auto p = a_offsets[col]; p != a_offsets[col + 1]; ++p)
+            {
+                if (mark[a_rows[p]] == k)
+                    continue;
+
+                stack.emplace_back(a_rows[p], size_type{0});
+                mark[a_rows[p]] = k;
+
+                while (!stack.empty())
+                {
+                    auto &[row, next] = stack.back();
+                    const auto step = pivot_step[row];
+
+                    bool descended = false;
+                    if (step != unassigned)
+                    {
+                        for (auto q = l_offsets_[step] + next; q != l_offsets_[step + 1]; ++q)
+                        {
+                            const auto child = l_rows_[q];
+                            if (mark[child] != k)
+                            {
+                                next = q - l_offsets_[step] + 1;
+                                mark[child] = k;
+                                stack.emplace_back(child, size_type{0});
+                                descended = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (!descended)
+                    {
+                        pattern.push_back(row);
+                        stack.pop_back();
+                    }
+                }
+            }
+            std::reverse(pattern.begin(), pattern.end());
+
+            // Numeric step: sparse triangular solve in the topological order
+            for (auto row : pattern)
+                x[row] = value_type{};
+            for (auto p = a_offsets[col]; p != a_offsets[col + 1]; ++p)
+                x[a_rows[p]] = a_values[p];
+
+            for (auto row : pattern)
+            {
+                const auto step = pivot_step[row];
+                if (step == unassigned)
+                    continue;
+
+                const auto x_row = x[row];
+                for (auto q = l_offsets_[step]; q != l_offsets_[step + 1]; ++q)
+                    x[l_rows_[q]] -= l_values_[q] * x_row;
+            }
+
+            // Pivot: the diagonal of the ordered matrix if it's large enough, the largest otherwise
+            size_type pivot_row = unassigned;
+            value_type largest{};
+            for (auto row : pattern)
+                if (pivot_step[row] == unassigned && std::abs(x[row]) > largest)
+                {
+                    largest = std::abs(x[row]);
+                    pivot_row = row;
+                }
+
+            if (pivot_row == unassigned || largest == value_type{})
+            {
+                singular_ = true;
+                return;
+            }
+
+            if (pivot_step[col] == unassigned && mark[col] == k &&
+                std::abs(x[col]) >= pivot_threshold * largest)
+                pivot_row = col;
+
+            const auto pivot = x[pivot_row];
+            pivot_step[pivot_row] = k;
+            row_perm_[k] = pivot_row;
+
+            // U(:, k) holds the rows pivoted before, with the pivot last; L(:, k) the rest
+            for (auto row : pattern)
+            {
+                if (row == pivot_row || x[row] == value_type{})
+                    continue;
+
+                if (pivot_step[row] != k && pivot_step[row] != unassigned)
+                {
+                    u_rows_.push_back(pivot_step[row]);
+                    u_values_.push_back(x[row]);
+                }
+                else
+                {
+                    l_rows_.push_back(row);
+                    l_values_.push_back(x[row] / pivot);
+                }
+            }
+            u_rows_.push_back(k);
+            u_values_.push_back(pivot);
+
+            l_offsets_.push_back(l_rows_.size());
+            u_offsets_.push_back(u_rows_.size());
+        }
+    }
+
+    std::vector<size_type> row_perm_;
+    std::vector<size_type> col_perm_;
+
+    std::vector<size_type> l_offsets_;
+    std::vector<size_type> l_rows_;
+    std::vector<value_type> l_values_;
+
+    std::vector<size_type> u_offsets_;
+    std::vector<size_type> u_rows_;
+    std::vector<value_type> u_values_;
+
+    bool singular_ = false;
+};
+
+template<typename T, Sparse_Layout Layout>
+requires std::is_arithmetic_v<T>
+Sparse_LU<T> Sparse_Matrix<T, Layout>::lu() const requires std::is_floating_point_v<T>
+{
+    return Sparse_LU<T>{*this};
+}
+
+// CSR of A is CSC of A^T, which has the same determinant, so CSR matrices aren't converted
+template<typename T, Sparse_Layout Layout>
+requires std::is_arithmetic_v<T>
+T Sparse_Matrix<T, Layout>::determinant() const requires std::is_floating_point_v<T>
+{
+    if (!is_square())
+        throw Undef_Det{};
+
+    if constexpr (Layout == Sparse_Layout::csc)
+        return Sparse_LU<T>{*this}.determinant();
+    else
+        return Sparse_LU<T>{transposed()}.determinant();
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_SPARSE_LU_HPP
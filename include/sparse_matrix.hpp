@@ -0,0 +1,503 @@
+#ifndef INCLUDE_SPARSE_MATRIX_HPP
+#define INCLUDE_SPARSE_MATRIX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "matrix_expr.hpp"
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+struct Bad_Sparse_Entry final : public std::out_of_range
+{
+    Bad_Sparse_Entry() : std::out_of_range{"The entry is out of the bounds of the sparse matrix"} {};
+};
+
+struct Bad_Sparse_Structure final : public std::invalid_argument
+{
+    Bad_Sparse_Structure()
+        : std::invalid_argument{"Offsets, indices and values don't describe a sparse matrix"} {};
+};
+
+// Nonzeros are stored by rows (CSR) or by columns (CSC)
+enum class Sparse_Layout
+{
+    csr,
+    csc
+};
+
+template<typename T>
+struct Triplet final
+{
+    std::size_t row;
+    std::size_t col;
+    T value;
+};
+
+template<typename T>
+class Sparse_LU;
+
+namespace detail
+{
+
+// Regroups the entries of n_major lines by their minor indices: CSR to CSC and back.
+// Minor indices come out sorted because lines are scanned in order.
+template<typename T>
+void transpose_compressed(std::size_t n_major, std::size_t n_minor,
+                          std::span<const std::size_t> offsets, std::span<const std::size_t> indices,
+                          std::span<const T> values, std::vector<std::size_t> &t_offsets,
+                          std::vector<std::size_t> &t_indices, std::vector<T> &t_values)
+{
+    t_offsets.assign(n_minor + 1, 0);
+    for (auto index : indices)
+        ++t_offsets[index + 1];
+    std::partial_sum(t_offsets.begin(), t_offsets.end(), t_offsets.begin());
+
+    std::vector<std::size_t> next(t_offsets.begin(), t_offsets.end() - 1);
+    for (std::size_t line = 0; line != n_major; ++line)
+        for (auto k = offsets[line]; k != offsets[line + 1]; ++k)
+        {
+            const auto pos = next[indices[k]]++;
+            t_indices[pos] = line;
+            t_values[pos] = values[k];
+        }
+}
+
+// Gustavson's algorithm for C = A * B with A and B in CSR: row i of C is the combination
+// of the rows of B selected by row i of A. A dense accumulator with a marker array makes
+// the time O(flops + nnz(C) + n), and rows of C are sorted at the end.
+template<typename T>
+void spgemm(std::size_t m, std::size_t n,
+            std::span<const std::size_t> a_offsets, std::span<const std::size_t> a_indices,
+            std::span<const T> a_values,
+            std::span<const std::size_t> b_offsets, std::span<const std::size_t> b_indices,
+            std::span<const T> b_values,
+            std::vector<std::size_t> &c_offsets, std::vector<std::size_t> &c_indices,
+            std::vector<T> &c_values)
+{
+    constexpr auto unmarked = static_cast<std::size_t>(-1);
+
+    std::vector<T> accumulator(n);
+    std::vector<std::size_t> marker(n, unmarked);
+
+    c_offsets.assign(m + 1, 0);
+    for (std::size_t i = 0; i != m; ++i)
+    {
+        const auto row_first = c_indices.size();
+
+        for (auto ka = a_offsets[i]; ka != a_offsets[i + 1]; ++ka)
+        {
+            const auto k = a_indices[ka];
+            const auto a_ik = a_values[ka];
+
+            for (auto kb = b_offsets[k]; kb != b_offsets[k + 1]; ++kb)
+            {
+                const auto j = b_indices[kb];
+                if (marker[j] != i)
+                {
+                    marker[j] = i;
+                    accumulator[j] = a_ik * b_values[kb];
+                    c_indices.push_back(j);
+                }
+                else
+                    accumulator[j] += a_ik * b_values[kb];
+            }
+        }
+
+        std::sort(c_indices.begin() + row_first, c_indices.end());
+
+        // Cancellations give zeros, which aren't stored
+        auto row_last = row_first;
+        for (auto k = row_first; k != c_indices.size(); ++k)
+        {
+            const auto j = c_indices[k];
+            if (accumulator[j] != T{})
+            {
+                c_indices[row_last++] = j;
+                c_values.push_back(accumulator[j]);
+            }
+        }
+        c_indices.resize(row_last);
+        c_offsets[i + 1] = row_last;
+    }
+}
+
+} // namespace detail
+
+// Compressed sparse matrix. The nonzeros of the major line i (a row in CSR, a column in CSC)
+// are values()[offsets()[i]], ..., values()[offsets()[i + 1] - 1]; their minor indices are in
+// indices() in increasing order. Memory is O(nnz + n) and so is the time of every operation
+// but products and the LU decomposition, which also scale with the number of nonzeros.
+// Explicit zeros are never stored.
+template<typename T, Sparse_Layout Layout = Sparse_Layout::csr>
+requires std::is_arithmetic_v<T>
+class Sparse_Matrix final
+{
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr Sparse_Layout layout = Layout;
+
+    // Constructors
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    Sparse_Matrix(size_type n_rows, size_type n_cols)
+        : n_rows_{n_rows}, n_cols_{n_cols}, offsets_(n_major() + 1) {}
+
+    // Entries may come in any order; duplicates are summed up
+    template<std::input_iterator It>
+    Sparse_Matrix(size_type n_rows, size_type n_cols, It first, It last)
+        : Sparse_Matrix(n_rows, n_cols)
+    {
+        std::vector<Triplet<value_type>> entries(first, last);
+        for (const auto &entry : entries)
+            if (entry.row >= n_rows_ || entry.col >= n_cols_)
+                throw Bad_Sparse_Entry{};
+
+        // Counting sort by major index, then sorting of every line by minor index
+        for (const auto &entry : entries)
+            ++offsets_[major(entry) + 1];
+        std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+        std::vector<std::pair<size_type, value_type>> line_entries(entries.size());
+        auto next = offsets_;
+        for (const auto &entry : entries)
+            line_entries[next[major(entry)]++] = {minor(entry), entry.value};
+
+        indices_.reserve(entries.size());
+        values_.reserve(entries.size());
+        for (size_type line = 0; line != n_major(); ++line)
+        {
+            const auto line_first = line_entries.begin() + offsets_[line];
+            const auto line_last = line_entries.begin() + offsets_[line + 1];
+            std::sort(line_first, line_last,
+                      [](const auto &lhs, const auto &rhs){ return lhs.first < rhs.first; });
+
+            offsets_[line] = indices_.size();
+            for (auto it = line_first; it != line_last;)
+            {
+                const auto index = it->first;
+                value_type sum{};
+                for (; it != line_last && it->first == index; ++it)
+                    sum += it->second;
+
+                if (sum != value_type{})
+                {
+                    indices_.push_back(index);
+                    values_.push_back(sum);
+                }
+            }
+        }
+        offsets_.back() = indices_.size();
+    }
+
+    Sparse_Matrix(size_type n_rows, size_type n_cols, std::span<const Triplet<value_type>> entries)
+        : Sparse_Matrix(n_rows, n_cols, entries.begin(), entries.end()) {}
+
+    Sparse_Matrix(size_type n_rows, size_type n_cols, std::initializer_list<Triplet<value_type>> ilist)
+        : Sparse_Matrix(n_rows, n_cols, ilist.begin(), ilist.end()) {}
+
+    // Takes over compressed arrays, e.g. ones read from a file. They are checked in O(nnz + n):
+    // offsets must be nondecreasing, minor indices strictly increasing in every line, and
+    // values nonzero.
+    Sparse_Matrix(size_type n_rows, size_type n_cols, std::vector<size_type> offsets,
+                  std::vector<size_type> indices, std::vector<value_type> values)
+        : n_rows_{n_rows}, n_cols_{n_cols}, offsets_(std::move(offsets)),
+          indices_(std::move(indices)), values_(std::move(values))
+    {
+        if (offsets_.size() != n_major() + 1 || offsets_.front() != 0 ||
+            offsets_.back() != indices_.size() || indices_.size() != values_.size())
+            throw Bad_Sparse_Structure{};
+
+        for (size_type line = 0; line != n_major(); ++line)
+        {
+            if (offsets_[line] > offsets_[line + 1])
+                throw Bad_Sparse_Structure{};
+
+            for (auto k = offsets_[line]; k != offsets_[line + 1]; ++k)
+                if (indices_[k] >= n_minor() || (k != offsets_[line] && indices_[k - 1] >= indices_[k]) ||
+                    values_[k] == value_type{})
+                    throw Bad_Sparse_Structure{};
+        }
+    }
+
+    // Zero elements of a dense matrix, a view or an expression are dropped
+    template<Matrix_Expression E>
+    requires std::is_same_v<std::remove_const_t<expr_value_t<E>>, value_type>
+    explicit Sparse_Matrix(const E &expr) : Sparse_Matrix(expr.n_rows(), expr.n_cols())
+    {
+        for (size_type line = 0; line != n_major(); ++line)
+        {
+            for (size_type index = 0; index != n_minor(); ++index)
+            {
+                const value_type value = (Layout == Sparse_Layout::csr)
+                                       ? detail::element(expr, line, index)
+                                       : detail::element(expr, index, line);
+                if (value != value_type{})
+                {
+                    indices_.push_back(index);
+                    values_.push_back(value);
+                }
+            }
+            offsets_[line + 1] = indices_.size();
+        }
+    }
+
+    // Conversion between CSR and CSC is a counting sort: O(nnz + n)
+    template<Sparse_Layout Other>
+    requires (Other != Layout)
+    explicit Sparse_Matrix(const Sparse_Matrix<value_type, Other> &rhs)
+        : n_rows_{rhs.n_rows()}, n_cols_{rhs.n_cols()}, offsets_(n_major() + 1),
+          indices_(rhs.nnz()), values_(rhs.nnz())
+    {
+        detail::transpose_compressed(rhs.n_major(), n_major(), rhs.offsets(), rhs.indices(),
+                                     rhs.values(), offsets_, indices_, values_);
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Fields and elements access
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    size_type n_rows() const noexcept { return n_rows_; }
+    size_type n_cols() const noexcept { return n_cols_; }
+    size_type nnz() const noexcept { return values_.size(); }
+
+    // The number of rows in CSR and of columns in CSC
+    size_type n_major() const noexcept { return Layout == Sparse_Layout::csr ? n_rows_ : n_cols_; }
+    size_type n_minor() const noexcept { return Layout == Sparse_Layout::csr ? n_cols_ : n_rows_; }
+
+    std::span<const size_type> offsets() const noexcept { return offsets_; }
+    std::span<const size_type> indices() const noexcept { return indices_; }
+    std::span<const value_type> values() const noexcept { return values_; }
+
+    bool is_square() const noexcept { return n_rows_ == n_cols_; }
+
+    // O(log(nnz in the line))
+    value_type operator()(size_type row_i, size_type col_i) const
+    {
+        if (row_i >= n_rows_ || col_i >= n_cols_)
+            throw Bad_Sparse_Entry{};
+
+        const auto line = (Layout == Sparse_Layout::csr) ? row_i : col_i;
+        const auto index = (Layout == Sparse_Layout::csr) ? col_i : row_i;
+
+        const auto first = indices_.begin() + offsets_[line];
+        const auto last = indices_.begin() + offsets_[line + 1];
+        const auto it = std::lower_bound(first, last, index);
+
+        return (it != last && *it == index) ? values_[it - indices_.begin()] : value_type{};
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // Some convenient methods
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    template<typename Allocator = std::allocator<value_type>>
+    Matrix<value_type, Allocator> to_matrix(const Allocator &alloc = Allocator{}) const
+    {
+        Matrix<value_type, Allocator> dense{n_rows_, n_cols_, value_type{}, alloc};
+
+        for (size_type line = 0; line != n_major(); ++line)
+            for (auto k = offsets_[line]; k != offsets_[line + 1]; ++k)
+            {
+                if constexpr (Layout == Sparse_Layout::csr)
+                    dense[line][indices_[k]] = values_[k];
+                else
+                    dense[indices_[k]][line] = values_[k];
+            }
+
+        return dense;
+    }
+
+    // CSR of a matrix is CSC of its transpose, so nothing is sorted
+    auto transposed() const
+    {
+        constexpr auto other = (Layout == Sparse_Layout::csr) ? Sparse_Layout::csc : Sparse_Layout::csr;
+
+        Sparse_Matrix<value_type, other> transposed{n_cols_, n_rows_};
+        transposed.offsets_ = offsets_;
+        transposed.indices_ = indices_;
+        transposed.values_ = values_;
+        return transposed;
+    }
+
+    // Defined in sparse_lu.hpp
+    Sparse_LU<T> lu() const requires std::is_floating_point_v<T>;
+    value_type determinant() const requires std::is_floating_point_v<T>;
+
+    friend bool operator==(const Sparse_Matrix &lhs, const Sparse_Matrix &rhs) noexcept
+    {
+        return lhs.n_rows_ == rhs.n_rows_ && lhs.n_cols_ == rhs.n_cols_ &&
+               lhs.offsets_ == rhs.offsets_ && lhs.indices_ == rhs.indices_ &&
+               lhs.values_ == rhs.values_;
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+private:
+
+    template<typename U, Sparse_Layout Other>
+    requires std::is_arithmetic_v<U>
+    friend class Sparse_Matrix;
+
+    size_type major(const Triplet<value_type> &entry) const noexcept
+    {
+        return Layout == Sparse_Layout::csr ? entry.row : entry.col;
+    }
+
+    size_type minor(const Triplet<value_type> &entry) const noexcept
+    {
+        return Layout == Sparse_Layout::csr ? entry.col : entry.row;
+    }
+
+    size_type n_rows_;
+    size_type n_cols_;
+    std::vector<size_type> offsets_;
+    std::vector<size_type> indices_;
+    std::vector<value_type> values_;
+};
+
+template<typename T>
+using CSR_Matrix = Sparse_Matrix<T, Sparse_Layout::csr>;
+
+template<typename T>
+using CSC_Matrix = Sparse_Matrix<T, Sparse_Layout::csc>;
+
+// Sparse matrix-vector products
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// y = A * x, where x is any contiguous range, e.g. std::vector. CSR computes a dot product
+// per row, CSC scatters every column.
+template<typename T, Sparse_Layout Layout>
+std::vector<T> product(const Sparse_Matrix<T, Layout> &lhs,
+                       std::type_identity_t<std::span<const T>> rhs)
+{
+    if (lhs.n_cols() != rhs.size())
+        throw Undef_Product{};
+
+    const auto offsets = lhs.offsets();
+    const auto indices = lhs.indices();
+    const auto values = lhs.values();
+
+    std::vector<T> result(lhs.n_rows());
+    for (std::size_t line = 0; line != lhs.n_major(); ++line)
+    {
+        if constexpr (Layout == Sparse_Layout::csr)
+        {
+            T sum{};
+            for (auto k = offsets[line]; k != offsets[line + 1]; ++k)
+                sum += values[k] * rhs[indices[k]];
+            result[line] = sum;
+        }
+        else
+        {
+            const T x = rhs[line];
+            for (auto k = offsets[line]; k != offsets[line + 1]; ++k)
+                result[indices[k]] += values[k] * x;
+        }
+    }
+
+    return result;
+}
+
+template<typename T, Sparse_Layout Layout>
+std::vector<T> product(execution::Sequenced_Policy, const Sparse_Matrix<T, Layout> &lhs,
+                       std::type_identity_t<std::span<const T>> rhs)
+{
+    return product(lhs, rhs);
+}
+
+// Rows of a CSR matrix are split between the threads. Columns of a CSC matrix would be
+// scattered into the same elements of y by different threads, so it's sequential.
+template<typename T, Sparse_Layout Layout>
+std::vector<T> product(const execution::Parallel_Policy &policy,
+                       const Sparse_Matrix<T, Layout> &lhs,
+                       std::type_identity_t<std::span<const T>> rhs)
+{
+    if constexpr (Layout == Sparse_Layout::csc)
+        return product(lhs, rhs);
+    else
+    {
+        if (lhs.n_cols() != rhs.size())
+            throw Undef_Product{};
+
+        const auto offsets = lhs.offsets();
+        const auto indices = lhs.indices();
+        const auto values = lhs.values();
+
+        std::vector<T> result(lhs.n_rows());
+
+        constexpr std::size_t rows_per_task = 256;
+        const auto n_tasks = (lhs.n_rows() + rows_per_task - 1) / rows_per_task;
+
+        policy.get_pool().parallel_for(n_tasks, [&](std::size_t task)
+        {
+            const auto first = task * rows_per_task;
+            const auto last = std::min(first + rows_per_task, lhs.n_rows());
+
+            for (auto row = first; row != last; ++row)
+            {
+                T sum{};
+                for (auto k = offsets[row]; k != offsets[row + 1]; ++k)
+                    sum += values[k] * rhs[indices[k]];
+                result[row] = sum;
+            }
+        });
+
+        return result;
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// C = A * B. The product is in CSC if both operands are, and in CSR otherwise; a CSC operand
+// multiplied by a CSR one is converted. Two CSC operands are multiplied as C^T = B^T * A^T,
+// since CSR of B^T is CSC of B.
+template<typename T, Sparse_Layout L, Sparse_Layout R>
+auto product(const Sparse_Matrix<T, L> &lhs, const Sparse_Matrix<T, R> &rhs)
+{
+    if (lhs.n_cols() != rhs.n_rows())
+        throw Undef_Product{};
+
+    if constexpr (L != R)
+    {
+        if constexpr (L == Sparse_Layout::csc)
+            return product(CSR_Matrix<T>{lhs}, rhs);
+        else
+            return product(lhs, CSR_Matrix<T>{rhs});
+    }
+    else
+    {
+        constexpr bool is_csr = (L == Sparse_Layout::csr);
+        const auto &a = is_csr ? lhs : rhs;
+        const auto &b = is_csr ? rhs : lhs;
+
+        std::vector<std::size_t> offsets, indices;
+        std::vector<T> values;
+        detail::spgemm(a.n_major(), b.n_minor(), a.offsets(), a.indices(), a.values(),
+                       b.offsets(), b.indices(), b.values(), offsets, indices, values);
+
+        return Sparse_Matrix<T, L>{lhs.n_rows(), rhs.n_cols(), std::move(offsets),
+                                   std::move(indices), std::move(values)};
+    }
+}
+
+} // namespace yLab
+
+#endif // INCLUDE_SPARSE_MATRIX_HPP
@@ -0,0 +1,317 @@
+#ifndef INCLUDE_STATS_HPP
+#define INCLUDE_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace yLab
+{
+
+// Opt-in instrumentation of the hot paths. With YLAB_STATS defined, determinant(), product(),
+// transpose() and copies of matrices record the number of calls, their time, FLOP and byte
+// counts, pivot swaps and allocations, and the time of every phase of the algorithms.
+// Otherwise every hook below is an empty inline function and compiles to nothing.
+//
+// Counters are global and atomic. An operation owns the counters of the thread which runs it,
+// so work done by the thread pool on behalf of an operation is included in its time only.
+namespace stats
+{
+
+#ifdef YLAB_STATS
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+enum class Op
+{
+    determinant,
+    product,
+    transpose,
+    copy
+};
+
+enum class Phase
+{
+    copy,
+    pivot_search,
+    row_swap,
+    elimination,
+    multiplication,
+    transposition
+};
+
+inline constexpr std::size_t n_ops = 4;
+inline constexpr std::size_t n_phases = 6;
+
+using Duration = std::chrono::nanoseconds;
+
+constexpr std::string_view name(Op op) noexcept
+{
+    constexpr std::array<std::string_view, n_ops> names = {"determinant", "product", "transpose", "copy"};
+    return names[static_cast<std::size_t>(op)];
+}
+
+constexpr std::string_view name(Phase phase) noexcept
+{
+    constexpr std::array<std::string_view, n_phases> names = {
+        "copy", "pivot search", "row swaps", "elimination", "multiplication", "transposition"};
+    return names[static_cast<std::size_t>(phase)];
+}
+
+struct Op_Stats final
+{
+    std::uint64_t calls = 0;
+    std::uint64_t flops = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t pivot_swaps = 0;
+    std::uint64_t allocations = 0;
+    Duration time{};
+};
+
+struct Stats final
+{
+    std::array<Op_Stats, n_ops> ops{};
+    std::array<Duration, n_phases> phases{};
+
+    const Op_Stats &operator[](Op op) const noexcept { return ops[static_cast<std::size_t>(op)]; }
+    Duration operator[](Phase phase) const noexcept { return phases[static_cast<std::size_t>(phase)]; }
+};
+
+// What happened between two snapshots
+inline Stats operator-(const Stats &lhs, const Stats &rhs) noexcept
+{
+    Stats diff;
+
+    for (std::size_t i = 0; i != n_ops; ++i)
+    {
+        diff.ops[i].calls = lhs.ops[i].calls - rhs.ops[i].calls;
+        diff.ops[i].flops = lhs.ops[i].flops - rhs.ops[i].flops;
+        diff.ops[i].bytes = lhs.ops[i].bytes - rhs.ops[i].bytes;
+        diff.ops[i].pivot_swaps = lhs.ops[i].pivot_swaps - rhs.ops[i].pivot_swaps;
+        diff.ops[i].allocations = lhs.ops[i].allocations - rhs.ops[i].allocations;
+        diff.ops[i].time = lhs.ops[i].time - rhs.ops[i].time;
+    }
+
+    for (std::size_t i = 0; i != n_phases; ++i)
+        diff.phases[i] = lhs.phases[i] - rhs.phases[i];
+
+    return diff;
+}
+
+namespace detail
+{
+
+struct Op_Counters final
+{
+    std::atomic<std::uint64_t> calls = 0;
+    std::atomic<std::uint64_t> flops = 0;
+    std::atomic<std::uint64_t> bytes = 0;
+    std::atomic<std::uint64_t> pivot_swaps = 0;
+    std::atomic<std::uint64_t> allocations = 0;
+    std::atomic<std::int64_t> time = 0;
+};
+
+struct Registry final
+{
+    std::array<Op_Counters, n_ops> ops;
+    std::array<std::atomic<std::int64_t>, n_phases> phases{};
+};
+
+inline Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// The innermost operation running in this thread, if any
+inline thread_local Op_Counters *current_op = nullptr;
+
+inline void add(std::atomic<std::uint64_t> Op_Counters::*counter, std::uint64_t value) noexcept
+{
+    if (current_op)
+        (current_op->*counter).fetch_add(value, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+inline Stats snapshot()
+{
+    Stats stats;
+    if constexpr (enabled)
+    {
+        auto &registry = detail::registry();
+
+        for (std::size_t i = 0; i != n_ops; ++i)
+        {
+            const auto &counters = registry.ops[i];
+            stats.ops[i] = Op_Stats{counters.calls.load(std::memory_order_relaxed),
+                                    counters.flops.load(std::memory_order_relaxed),
+                                    counters.bytes.load(std::memory_order_relaxed),
+                                    counters.pivot_swaps.load(std::memory_order_relaxed),
+                                    counters.allocations.load(std::memory_order_relaxed),
+                                    Duration{counters.time.load(std::memory_order_relaxed)}};
+        }
+
+        for (std::size_t i = 0; i != n_phases; ++i)
+            stats.phases[i] = Duration{registry.phases[i].load(std::memory_order_relaxed)};
+    }
+
+    return stats;
+}
+
+inline void reset()
+{
+    if constexpr (enabled)
+    {
+        auto &registry = detail::registry();
+
+        for (auto &counters : registry.ops)
+        {
+            counters.calls = 0;
+            counters.flops = 0;
+            counters.bytes = 0;
+            counters.pivot_swaps = 0;
+            counters.allocations = 0;
+            counters.time = 0;
+        }
+
+        for (auto &phase : registry.phases)
+            phase = 0;
+    }
+}
+
+// Hooks
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Marks a call of op: counts it, measures its time and makes it the owner of the counters
+// incremented by this thread until the end of the scope
+class Scope final
+{
+public:
+
+#ifdef YLAB_STATS
+    explicit Scope(Op op) noexcept
+        : counters_{&detail::registry().ops[static_cast<std::size_t>(op)]},
+          outer_{std::exchange(detail::current_op, counters_)},
+          start_{std::chrono::steady_clock::now()}
+    {
+        counters_->calls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~Scope()
+    {
+        const auto time = std::chrono::steady_clock::now() - start_;
+        counters_->time.fetch_add(std::chrono::duration_cast<Duration>(time).count(),
+                                  std::memory_order_relaxed);
+        detail::current_op = outer_;
+    }
+#else
+    explicit Scope(Op) noexcept {}
+#endif
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+#ifdef YLAB_STATS
+private:
+
+    detail::Op_Counters *counters_;
+    detail::Op_Counters *outer_;
+    std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+// Adds the time until the end of the scope to phase
+class Phase_Timer final
+{
+public:
+
+#ifdef YLAB_STATS
+    explicit Phase_Timer(Phase phase) noexcept
+        : phase_{static_cast<std::size_t>(phase)}, start_{std::chrono::steady_clock::now()} {}
+
+    ~Phase_Timer()
+    {
+        const auto time = std::chrono::steady_clock::now() - start_;
+        detail::registry().phases[phase_].fetch_add(std::chrono::duration_cast<Duration>(time).count(),
+                                                    std::memory_order_relaxed);
+    }
+#else
+    explicit Phase_Timer(Phase) noexcept {}
+#endif
+
+    Phase_Timer(const Phase_Timer &) = delete;
+    Phase_Timer &operator=(const Phase_Timer &) = delete;
+
+#ifdef YLAB_STATS
+private:
+
+    std::size_t phase_;
+    std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+// Counters of the innermost operation running in this thread. Outside of operations they do nothing.
+
+inline void add_flops([[maybe_unused]] std::uint64_t flops) noexcept
+{
+    if constexpr (enabled)
+        detail::add(&detail::Op_Counters::flops, flops);
+}
+
+inline void add_bytes([[maybe_unused]] std::uint64_t bytes) noexcept
+{
+    if constexpr (enabled)
+        detail::add(&detail::Op_Counters::bytes, bytes);
+}
+
+inline void add_pivot_swaps([[maybe_unused]] std::uint64_t n_swaps = 1) noexcept
+{
+    if constexpr (enabled)
+        detail::add(&detail::Op_Counters::pivot_swaps, n_swaps);
+}
+
+inline void count_allocation() noexcept
+{
+    if constexpr (enabled)
+        detail::add(&detail::Op_Counters::allocations, 1);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+inline std::ostream &operator<<(std::ostream &os, const Stats &stats)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    for (std::size_t i = 0; i != n_ops; ++i)
+    {
+        const auto &op = stats.ops[i];
+        if (op.calls == 0)
+            continue;
+
+        os << name(static_cast<Op>(i)) << ": " << op.calls << " calls, "
+           << Milliseconds{op.time}.count() << " ms, "
+           << op.flops << " flops, " << op.bytes << " bytes, "
+           << op.pivot_swaps << " pivot swaps, " << op.allocations << " allocations\n";
+    }
+
+    for (std::size_t i = 0; i != n_phases; ++i)
+        if (stats.phases[i] != Duration{})
+            os << "  " << name(static_cast<Phase>(i)) << ": "
+               << Milliseconds{stats.phases[i]}.count() << " ms\n";
+
+    return os;
+}
+
+} // namespace stats
+
+} // namespace yLab
+
+#endif // INCLUDE_STATS_HPP
@@ -0,0 +1,244 @@
+#ifndef INCLUDE_STRUCTURE_HPP
+#define INCLUDE_STRUCTURE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace yLab
+{
+
+// Nonzero patterns of square matrices which have cheaper determinants than general ones.
+// A structure passed to Matrix::determinant() is trusted: elements outside of it are
+// treated as zeros.
+namespace structure
+{
+
+struct General final {};
+struct Diagonal final {};
+struct Lower_Triangular final {};
+struct Upper_Triangular final {};
+struct Tridiagonal final {};
+
+// Element (i, j) is zero if i - j > lower or j - i > upper
+struct Banded final
+{
+    std::size_t lower;
+    std::size_t upper;
+};
+
+// Diagonal blocks [offsets[k], offsets[k + 1]); the first offset is 0 and the last one is n
+struct Block_Diagonal final
+{
+    std::vector<std::size_t> offsets;
+};
+
+} // namespace structure
+
+using Structure = std::variant<structure::General, structure::Diagonal,
+                               structure::Lower_Triangular, structure::Upper_Triangular,
+                               structure::Tridiagonal, structure::Banded,
+                               structure::Block_Diagonal>;
+
+namespace detail
+{
+
+// Offsets of blocks of an n x n matrix: they start at 0, end at n and strictly increase
+inline bool are_valid_blocks(const std::vector<std::size_t> &offsets, std::size_t n) noexcept
+{
+    return !offsets.empty() && offsets.front() == 0 && offsets.back() == n &&
+           std::ranges::adjacent_find(offsets, std::ranges::greater_equal{}) == offsets.end();
+}
+
+// Banded elimination costs about n * lower * (lower + upper) operations against n^3 / 3 of
+// the general one; with this limit it's at least a few times faster
+inline bool is_narrow_band(std::size_t n, std::size_t lower, std::size_t upper) noexcept
+{
+    return 4 * (lower + upper) <= n;
+}
+
+// The narrowest of the structures above which the n x n matrix has. Rows are scanned from
+// both ends towards the diagonal, so that only the zeros and the outermost nonzero of every
+// row are read: a dense matrix is recognized in O(n), and the cost of a sparse one is
+// proportional to its zeros, which is O(n^2) at worst.
+template<typename T>
+Structure detect_structure(std::size_t n, const T *data, std::size_t stride)
+{
+    if (n < 2)
+        return structure::Diagonal{};
+
+    std::size_t lower = 0, upper = 0;
+    std::vector<std::size_t> first(n), last(n);
+
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        const T *row = data + i * stride;
+
+        std::size_t j = 0;
+        while (j < i && row[j] == T{})
+            ++j;
+        first[i] = j;
+
+        std::size_t k = n - 1;
+        while (k > i && row[k] == T{})
+            --k;
+        last[i] = k;
+
+        lower = std::max(lower, i - first[i]);
+        upper = std::max(upper, last[i] - i);
+    }
+
+    if (lower == 0 && upper == 0)
+        return structure::Diagonal{};
+    if (lower == 0)
+        return structure::Upper_Triangular{};
+    if (upper == 0)
+        return structure::Lower_Triangular{};
+    if (lower == 1 && upper == 1)
+        return structure::Tridiagonal{};
+    if (is_narrow_band(n, lower, upper))
+        return structure::Banded{lower, upper};
+
+    // A block ends before row k if no row above reaches column k and no row below
+    // reaches column k - 1
+    std::vector<std::size_t> min_first(n + 1, n);
+    for (std::size_t i = n; i-- != 0;)
+        min_first[i] = std::min(min_first[i + 1], first[i]);
+
+    structure::Block_Diagonal blocks{{0}};
+    std::size_t max_last = 0;
+    for (std::size_t k = 1; k != n; ++k)
+    {
+        max_last = std::max(max_last, last[k - 1]);
+        if (max_last < k && min_first[k] >= k)
+            blocks.offsets.push_back(k);
+    }
+    blocks.offsets.push_back(n);
+
+    if (blocks.offsets.size() > 2)
+        return blocks;
+    return structure::General{};
+}
+
+// Product of the diagonal: determinant of diagonal and triangular matrices
+template<typename T>
+T diagonal_product(std::size_t n, const T *data, std::size_t stride) noexcept
+{
+    T determinant{1};
+    for (std::size_t i = 0; i != n; ++i)
+        determinant *= data[i * (stride + 1)];
+    return determinant;
+}
+
+// Continuant of a tridiagonal matrix: f_k = a_kk * f_(k-1) - a_k(k-1) * a_(k-1)k * f_(k-2).
+// It's the Thomas algorithm without divisions, so integral determinants are exact. It doesn't
+// pivot, so floating point matrices go to banded_determinant() with unit bandwidths instead.
+template<typename T>
+T tridiagonal_determinant(std::size_t n, const T *data, std::size_t stride) noexcept
+{
+    auto elem = [&](std::size_t i, std::size_t j){ return data[i * stride + j]; };
+
+    T previous{1};
+    T current = elem(0, 0);
+    for (std::size_t k = 1; k != n; ++k)
+        previous = std::exchange(current,
+                                 elem(k, k) * current - elem(k, k - 1) * elem(k - 1, k) * previous);
+    return current;
+}
+
+// Elimination in band storage of n * (2 * lower + upper + 1) elements: row i holds
+// columns [i - lower, i + lower + upper], as row swaps widen the upper band by lower.
+// Pivots are searched in the lower + 1 rows which may have nonzeros in their column.
+// Floating point matrices are eliminated by Gauss algorithm, integral ones by Bareiss
+// algorithm. In the latter, every elimination step multiplies all the rows below by the
+// pivot, so a row is brought up to date when it enters the window of the pivot search.
+template<typename T>
+T banded_determinant(std::size_t n, const T *data, std::size_t stride,
+                     std::size_t lower, std::size_t upper)
+{
+    lower = std::min(lower, n - 1);
+    upper = std::min(upper, n - 1);
+
+    const auto width = 2 * lower + upper + 1;
+    std::vector<T> band(n * width);
+
+    // Column j of row i is at band[i * width + (j + lower - i)]
+    auto at = [&](std::size_t i, std::size_t j) -> T & { return band[i * width + j + lower - i]; };
+
+    for (std::size_t i = 0; i != n; ++i)
+    {
+        const auto first = i > lower ? i - lower : 0;
+        const auto last = std::min(n - 1, i + upper);
+        for (std::size_t j = first; j <= last; ++j)
+            at(i, j) = data[i * stride + j];
+    }
+
+    T determinant{1};
+    T init_val{1};
+    bool negate = false;
+
+    for (std::size_t k = 0; k != n; ++k)
+    {
+        const auto last_row = std::min(n - 1, k + lower);
+        const auto last_col = std::min(n - 1, k + lower + upper);
+
+        if constexpr (std::is_integral_v<T>)
+            if (k + lower < n && k != 0)
+                for (std::size_t j = k; j <= last_col; ++j)
+                    at(k + lower, j) *= init_val;
+
+        auto pivot_row = k;
+        for (auto i = k + 1; i <= last_row; ++i)
+            if (std::abs(at(pivot_row, k)) < std::abs(at(i, k)))
+                pivot_row = i;
+
+        if (at(pivot_row, k) == T{})
+            return T{};
+
+        if (pivot_row != k)
+        {
+            for (auto j = k; j <= last_col; ++j)
+                std::swap(at(k, j), at(pivot_row, j));
+            negate = !negate;
+        }
+
+        const T pivot = at(k, k);
+        for (auto i = k + 1; i <= last_row; ++i)
+        {
+            const T factor = at(i, k);
+            if constexpr (std::is_integral_v<T>)
+            {
+                for (auto j = k + 1; j <= last_col; ++j)
+                    at(i, j) = (pivot * at(i, j) - factor * at(k, j)) / init_val;
+            }
+            else
+            {
+                const T ratio = factor / pivot;
+                for (auto j = k + 1; j <= last_col; ++j)
+                    at(i, j) -= ratio * at(k, j);
+            }
+        }
+
+        if constexpr (std::is_integral_v<T>)
+            init_val = pivot;
+        else
+            determinant *= pivot;
+    }
+
+    // Bareiss algorithm leaves the determinant in the last pivot
+    if constexpr (std::is_integral_v<T>)
+        determinant = init_val;
+
+    return negate ? -determinant : determinant;
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_STRUCTURE_HPP
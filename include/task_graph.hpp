@@ -0,0 +1,136 @@
+#ifndef INCLUDE_TASK_GRAPH_HPP
+#define INCLUDE_TASK_GRAPH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+// Directed acyclic graph of tasks. A task becomes ready as soon as all its predecessors
+// have finished; ready tasks are spawned into a work-stealing Thread_Pool by the worker
+// that made them ready, so independent chains of work overlap freely.
+class Task_Graph final
+{
+public:
+
+    using size_type = std::size_t;
+    using task_id = std::size_t;
+
+    template<typename F>
+    task_id add_task(F &&func)
+    {
+        nodes_.push_back(Node{std::function<void()>(std::forward<F>(func)), {}, 0});
+        return nodes_.size() - 1;
+    }
+
+    // Task after can't start until task before has finished
+    void add_dependency(task_id before, task_id after)
+    {
+        nodes_[before].successors.push_back(after);
+        ++nodes_[after].n_predecessors;
+    }
+
+    size_type size() const noexcept { return nodes_.size(); }
+
+    // Runs every task and returns when all of them have finished. The calling thread
+    // runs pending tasks of the pool while waiting. If a task throws, the tasks which
+    // haven't started yet are skipped and the first exception is rethrown here.
+    void run(Thread_Pool &pool)
+    {
+        if (nodes_.empty())
+            return;
+
+        // Tasks share ownership of the state: the last of them may still be touching it
+        // after the waiting thread has returned
+        auto state = std::make_shared<Run_State>(pool, nodes_);
+
+        for (task_id id = 0; id != nodes_.size(); ++id)
+            if (nodes_[id].n_predecessors == 0)
+                state->spawn(id);
+
+        for (auto n_left = state->n_left.load(); n_left != 0; n_left = state->n_left.load())
+        {
+            if (!pool.run_pending_task())
+                state->n_left.wait(n_left);
+        }
+
+        if (state->exception)
+            std::rethrow_exception(state->exception);
+    }
+
+private:
+
+    struct Node final
+    {
+        std::function<void()> func;
+        std::vector<task_id> successors;
+        size_type n_predecessors;
+    };
+
+    struct Run_State final : public std::enable_shared_from_this<Run_State>
+    {
+        Run_State(Thread_Pool &pool_, std::vector<Node> &nodes_)
+            : pool{pool_}, nodes{nodes_},
+              n_waiting{std::make_unique<std::atomic<size_type>[]>(nodes_.size())},
+              n_left{nodes_.size()}
+        {
+            for (size_type i = 0; i != nodes.size(); ++i)
+                n_waiting[i] = nodes[i].n_predecessors;
+        }
+
+        void spawn(task_id id)
+        {
+            pool.execute([self = shared_from_this(), id]{ self->run_task(id); });
+        }
+
+        void run_task(task_id id)
+        {
+            if (!failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    nodes[id].func();
+                }
+                catch (...)
+                {
+                    std::lock_guard lock{mutex};
+                    if (!exception)
+                        exception = std::current_exception();
+                    failed = true;
+                }
+            }
+
+            for (auto succ : nodes[id].successors)
+                if (--n_waiting[succ] == 0)
+                    spawn(succ);
+
+            // Successors are spawned before the counter drops, so the waiting thread
+            // always finds them when it wakes up
+            --n_left;
+            n_left.notify_all();
+        }
+
+        Thread_Pool &pool;
+        std::vector<Node> &nodes;
+        std::unique_ptr<std::atomic<size_type>[]> n_waiting;
+        std::atomic<size_type> n_left;
+        std::atomic<bool> failed = false;
+        std::mutex mutex;
+        std::exception_ptr exception;
+    };
+
+    std::vector<Node> nodes_;
+};
+
+} // namespace yLab
+
+#endif // INCLUDE_TASK_GRAPH_HPP
@@ -0,0 +1,279 @@
+#ifndef INCLUDE_THREAD_POOL_HPP
+#define INCLUDE_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace yLab
+{
+
+// Work-stealing thread pool. Every worker owns a deque: tasks spawned by a worker go
+// to the back of its own deque and are taken back LIFO, which keeps their data hot
+// in cache; idle workers steal from the front of the other deques. Tasks submitted
+// from outside the pool go to a shared deque.
+class Thread_Pool final
+{
+public:
+
+    using size_type = std::size_t;
+
+    explicit Thread_Pool(size_type n_threads = default_n_threads())
+    {
+        n_threads = std::max<size_type>(n_threads, 1);
+
+        // The last queue is shared by threads which don't belong to the pool
+        queues_.reserve(n_threads + 1);
+        for (size_type i = 0; i != n_threads + 1; ++i)
+            queues_.push_back(std::make_unique<Task_Queue>());
+
+        workers_.reserve(n_threads);
+        for (size_type i = 0; i != n_threads; ++i)
+            workers_.emplace_back([this, i]{ worker_loop(i); });
+    }
+
+    Thread_Pool(const Thread_Pool &) = delete;
+    Thread_Pool &operator=(const Thread_Pool &) = delete;
+
+    // Every worker exits once it finds all the queues empty, so the tasks submitted
+    // before destruction are still run
+    ~Thread_Pool()
+    {
+        stop_ = true;
+        n_pending_.release(static_cast<std::ptrdiff_t>(workers_.size()));
+
+        for (auto &worker : workers_)
+            worker.join();
+    }
+
+    size_type n_threads() const noexcept { return workers_.size(); }
+
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F &&func)
+    {
+        using Result_T = std::invoke_result_t<F>;
+
+        auto task = std::make_shared<std::packaged_task<Result_T()>>(std::forward<F>(func));
+        auto future = task->get_future();
+        execute([task]{ (*task)(); });
+
+        return future;
+    }
+
+    // Fire-and-forget version of submit(): task must not throw
+    void execute(std::function<void()> task)
+    {
+        auto &queue = *queues_[own_queue_index()];
+        {
+            std::lock_guard lock{queue.mutex};
+            queue.tasks.push_back(std::move(task));
+        }
+        n_pending_.release();
+    }
+
+    // Runs one pending task, if there is any, in the calling thread. Threads waiting
+    // for work done in the pool call this instead of blocking, so that waiting inside
+    // a task can't starve the pool.
+    bool run_pending_task()
+    {
+        if (!n_pending_.try_acquire())
+            return false;
+
+        if (auto task = take_task(own_queue_index()))
+        {
+            (*task)();
+            return true;
+        }
+
+        return false;
+    }
+
+    // Calls func(i) for every i in [0, n_tasks) and returns when all calls have finished.
+    // The calling thread takes part in the work, so nested calls from inside a worker
+    // can't deadlock. The first exception thrown by func is rethrown in the caller.
+    template<typename F>
+    void parallel_for(size_type n_tasks, F &&func)
+    {
+        if (n_tasks == 0)
+            return;
+        if (n_tasks == 1)
+        {
+            func(size_type{0});
+            return;
+        }
+
+        struct Shared_State final
+        {
+            std::atomic<size_type> next = 0;
+            std::atomic<size_type> n_done = 0;
+            std::mutex mutex;
+            std::exception_ptr exception;
+        };
+
+        auto state = std::make_shared<Shared_State>();
+
+        auto run = [state, n_tasks, &func]
+        {
+            for (auto i = state->next++; i < n_tasks; i = state->next++)
+            {
+                try
+                {
+                    func(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock{state->mutex};
+                    if (!state->exception)
+                        state->exception = std::current_exception();
+                }
+
+                if (++state->n_done == n_tasks)
+                    state->n_done.notify_all();
+            }
+        };
+
+        // Helpers that start after every index has been claimed return at once,
+        // so they never touch func after this function has returned
+        const auto n_helpers = std::min(n_threads(), n_tasks - 1);
+        for (size_type i = 0; i != n_helpers; ++i)
+            execute(run);
+
+        run();
+
+        for (auto n_done = state->n_done.load(); n_done != n_tasks; n_done = state->n_done.load())
+            state->n_done.wait(n_done);
+
+        if (state->exception)
+            std::rethrow_exception(state->exception);
+    }
+
+    // The number of threads is taken from YLAB_NUM_THREADS environment variable
+    // if it's set, and from std::thread::hardware_concurrency() otherwise
+    static size_type default_n_threads()
+    {
+        if (const char *env = std::getenv("YLAB_NUM_THREADS"))
+        {
+            if (const auto n = std::strtoul(env, nullptr, 10); n != 0)
+                return n;
+        }
+
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    static Thread_Pool &default_pool()
+    {
+        static Thread_Pool pool;
+        return pool;
+    }
+
+private:
+
+    struct Task_Queue final
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    size_type own_queue_index() const noexcept
+    {
+        return (current_pool_ == this) ? current_index_ : workers_.size();
+    }
+
+    // The caller must have acquired n_pending_: then at least one task is queued
+    // somewhere, and only stop_ makes the search give up
+    std::optional<std::function<void()>> take_task(size_type own_i)
+    {
+        const auto n_queues = queues_.size();
+
+        for (;;)
+        {
+            {
+                auto &own = *queues_[own_i];
+                std::lock_guard lock{own.mutex};
+                if (!own.tasks.empty())
+                {
+                    auto task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return task;
+                }
+            }
+
+            for (size_type shift = 1; shift != n_queues; ++shift)
+            {
+                auto &victim = *queues_[(own_i + shift) % n_queues];
+                std::lock_guard lock{victim.mutex};
+                if (!victim.tasks.empty())
+                {
+                    auto task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return task;
+                }
+            }
+
+            if (stop_)
+                return std::nullopt;
+
+            std::this_thread::yield();
+        }
+    }
+
+    void worker_loop(size_type index)
+    {
+        current_pool_ = this;
+        current_index_ = index;
+
+        for (;;)
+        {
+            n_pending_.acquire();
+
+            auto task = take_task(index);
+            if (!task)
+                return;
+
+            (*task)();
+        }
+    }
+
+    inline static thread_local const Thread_Pool *current_pool_ = nullptr;
+    inline static thread_local size_type current_index_ = 0;
+
+    std::vector<std::unique_ptr<Task_Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::counting_semaphore<> n_pending_{0};
+    std::atomic<bool> stop_ = false;
+};
+
+namespace execution
+{
+
+struct Sequenced_Policy final {};
+
+struct Parallel_Policy final
+{
+    Thread_Pool *pool = nullptr;
+
+    Parallel_Policy on(Thread_Pool &other) const noexcept { return Parallel_Policy{&other}; }
+    Thread_Pool &get_pool() const { return pool ? *pool : Thread_Pool::default_pool(); }
+};
+
+inline constexpr Sequenced_Policy seq{};
+inline constexpr Parallel_Policy par{};
+
+} // namespace execution
+
+} // namespace yLab
+
+#endif // INCLUDE_THREAD_POOL_HPP
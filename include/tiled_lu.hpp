@@ -0,0 +1,210 @@
+#ifndef INCLUDE_TILED_LU_HPP
+#define INCLUDE_TILED_LU_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <vector>
+
+#include "gemm.hpp"
+#include "simd.hpp"
+#include "task_graph.hpp"
+#include "thread_pool.hpp"
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// Matrices of at least that size are decomposed by tiled_lu_decompose() in determinant()
+inline constexpr std::size_t tiled_lu_threshold = 512;
+
+inline std::size_t tiled_lu_block_size(std::size_t n) noexcept
+{
+    return (n <= 4096) ? 128 : 256;
+}
+
+template<typename T>
+void swap_row_segments(T *a, std::size_t lda, std::size_t row_1, std::size_t row_2,
+                       std::size_t first_col, std::size_t last_col)
+{
+    std::swap_ranges(a + row_1 * lda + first_col, a + row_1 * lda + last_col,
+                     a + row_2 * lda + first_col);
+}
+
+// Unblocked LU with partial pivoting of the panel [first_col, n) x [first_col, last_col).
+// Row swaps are applied to the panel columns only; ipiv[c] is the row swapped with row c.
+// Returns the sign of the panel permutation, or 0 if a zero column was met.
+template<std::floating_point T>
+int panel_decompose(std::size_t n, std::size_t first_col, std::size_t last_col,
+                    T *a, std::size_t lda, std::size_t *ipiv)
+{
+    int sign = 1;
+    bool is_singular = false;
+
+    for (std::size_t c = first_col; c != last_col; ++c)
+    {
+        std::size_t pivot_i = c;
+        T pivot_abs = std::abs(a[c * lda + c]);
+
+        for (std::size_t i = c + 1; i != n; ++i)
+        {
+            const T elem_abs = std::abs(a[i * lda + c]);
+            if (pivot_abs < elem_abs)
+            {
+                pivot_i = i;
+                pivot_abs = elem_abs;
+            }
+        }
+
+        ipiv[c] = pivot_i;
+
+        if (pivot_abs == T{})
+        {
+            is_singular = true;
+            continue;
+        }
+
+        if (pivot_i != c)
+        {
+            swap_row_segments(a, lda, c, pivot_i, first_col, last_col);
+            sign = -sign;
+        }
+
+        const T *pivot_row = a + c * lda;
+        const T pivot = pivot_row[c];
+
+        for (std::size_t i = c + 1; i != n; ++i)
+        {
+            T *row = a + i * lda;
+            const T coeff = row[c] / pivot;
+            row[c] = coeff;
+
+            simd::sub_scaled(last_col - c - 1, row + c + 1, pivot_row + c + 1, coeff);
+        }
+    }
+
+    return is_singular ? 0 : sign;
+}
+
+// Applies the row swaps of panel [first_col, last_col) to columns [col_begin, col_end)
+// and solves L_kk * X = A_kj for the block row of the panel
+template<std::floating_point T>
+void panel_row_update(std::size_t first_col, std::size_t last_col,
+                      std::size_t col_begin, std::size_t col_end,
+                      T *a, std::size_t lda, const std::size_t *ipiv)
+{
+    for (std::size_t c = first_col; c != last_col; ++c)
+        if (ipiv[c] != c)
+            swap_row_segments(a, lda, c, ipiv[c], col_begin, col_end);
+
+    for (std::size_t r = first_col + 1; r < last_col; ++r)
+    {
+        const T *l_row = a + r * lda;
+        T *x_r = a + r * lda;
+
+        for (std::size_t q = first_col; q != r; ++q)
+            simd::sub_scaled(col_end - col_begin, x_r + col_begin, a + q * lda + col_begin, l_row[q]);
+    }
+}
+
+// Right-looking tiled LU decomposition with partial pivoting of an n x n row-major matrix,
+// LAPACK-style: rows are physically swapped and ipiv[i] is the row swapped with row i.
+//
+// Every step k consists of three kinds of tasks:
+//   panel(k)      - factorization of block column k;
+//   row(k, j)     - row swaps and triangular solve for block (k, j);
+//   update(k,i,j) - trailing GEMM A_ij -= A_ik * A_kj.
+// They are scheduled as a DAG, so panel(k + 1) starts as soon as block column k + 1 has
+// been updated, while the rest of the trailing matrix of step k is still being updated.
+//
+// Returns the sign of the permutation, or 0 if the matrix is singular.
+template<std::floating_point T>
+int tiled_lu_decompose(Thread_Pool &pool, std::size_t n, T *a, std::size_t lda,
+                       std::size_t *ipiv, std::size_t block_size = 0)
+{
+    if (n == 0)
+        return 1;
+    if (block_size == 0)
+        block_size = tiled_lu_block_size(n);
+
+    using task_id = Task_Graph::task_id;
+
+    const auto n_tiles = (n + block_size - 1) / block_size;
+    auto tile_begin = [block_size](std::size_t t){ return t * block_size; };
+    auto tile_end = [block_size, n](std::size_t t){ return std::min((t + 1) * block_size, n); };
+
+    std::vector<int> panel_signs(n_tiles);
+
+    Task_Graph graph;
+
+    // Updates of the previous step, indexed by [i][j]
+    std::vector<task_id> prev_update(n_tiles * n_tiles);
+
+    for (std::size_t k = 0; k != n_tiles; ++k)
+    {
+        const auto first_col = tile_begin(k);
+        const auto last_col = tile_end(k);
+
+        const auto panel = graph.add_task([=, &panel_signs]
+        {
+            panel_signs[k] = panel_decompose(n, first_col, last_col, a, lda, ipiv);
+        });
+
+        if (k != 0)
+            for (std::size_t i = k; i != n_tiles; ++i)
+                graph.add_dependency(prev_update[i * n_tiles + k], panel);
+
+        for (std::size_t j = k + 1; j != n_tiles; ++j)
+        {
+            const auto row = graph.add_task([=]
+            {
+                panel_row_update(first_col, last_col, tile_begin(j), tile_end(j), a, lda, ipiv);
+            });
+
+            graph.add_dependency(panel, row);
+            if (k != 0)
+                for (std::size_t i = k; i != n_tiles; ++i)
+                    graph.add_dependency(prev_update[i * n_tiles + j], row);
+
+            for (std::size_t i = k + 1; i != n_tiles; ++i)
+            {
+                const auto update = graph.add_task([=]
+                {
+                    const auto row_i = tile_begin(i);
+                    const auto col_j = tile_begin(j);
+
+                    gemm(tile_end(i) - row_i, tile_end(j) - col_j, last_col - first_col,
+                         a + row_i * lda + first_col, lda,
+                         a + first_col * lda + col_j, lda,
+                         a + row_i * lda + col_j, lda, T{-1});
+                });
+
+                graph.add_dependency(row, update);
+                prev_update[i * n_tiles + j] = update;
+            }
+        }
+    }
+
+    graph.run(pool);
+
+    // Swaps of later panels haven't been applied to the columns of L to the left of them
+    for (std::size_t k = 1; k != n_tiles; ++k)
+        for (std::size_t c = tile_begin(k); c != tile_end(k); ++c)
+            if (ipiv[c] != c)
+                swap_row_segments(a, lda, c, ipiv[c], 0, tile_begin(k));
+
+    int sign = 1;
+    for (auto panel_sign : panel_signs)
+        sign *= panel_sign;
+
+    return sign;
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_TILED_LU_HPP
@@ -0,0 +1,122 @@
+#ifndef INCLUDE_TRANSPOSE_HPP
+#define INCLUDE_TRANSPOSE_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace yLab
+{
+
+namespace detail
+{
+
+// Cache-oblivious transposition: the larger dimension is halved recursively until a block
+// fits into L1 whatever its size is, so rows and columns are both read in whole cache lines.
+
+// Blocks of at most transpose_leaf x transpose_leaf elements are transposed directly
+inline constexpr std::size_t transpose_leaf = 16;
+
+// dst = src^T, where src is m x n with leading dimension lds and dst is n x m
+template<typename T>
+void transpose_copy(std::size_t m, std::size_t n, const T *src, std::size_t lds,
+                    T *dst, std::size_t ldd)
+{
+    if (m <= transpose_leaf && n <= transpose_leaf)
+    {
+        for (std::size_t i = 0; i != m; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                dst[j * ldd + i] = src[i * lds + j];
+    }
+    else if (m >= n)
+    {
+        const auto half = m / 2;
+        transpose_copy(half, n, src, lds, dst, ldd);
+        transpose_copy(m - half, n, src + half * lds, lds, dst + half, ldd);
+    }
+    else
+    {
+        const auto half = n / 2;
+        transpose_copy(m, half, src, lds, dst, ldd);
+        transpose_copy(m, n - half, src + half, lds, dst + half * ldd, ldd);
+    }
+}
+
+// Swaps m x n block a with the transpose of n x m block b
+template<typename T>
+void transpose_swap(std::size_t m, std::size_t n, T *a, T *b, std::size_t ld)
+{
+    if (m <= transpose_leaf && n <= transpose_leaf)
+    {
+        for (std::size_t i = 0; i != m; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                std::swap(a[i * ld + j], b[j * ld + i]);
+    }
+    else if (m >= n)
+    {
+        const auto half = m / 2;
+        transpose_swap(half, n, a, b, ld);
+        transpose_swap(m - half, n, a + half * ld, b + half, ld);
+    }
+    else
+    {
+        const auto half = n / 2;
+        transpose_swap(m, half, a, b, ld);
+        transpose_swap(m, n - half, a + half, b + half * ld, ld);
+    }
+}
+
+// In-place transposition of an n x n matrix: diagonal blocks are transposed recursively,
+// and the off-diagonal ones are swapped with each other's transposes
+template<typename T>
+void transpose_square(std::size_t n, T *a, std::size_t lda)
+{
+    if (n <= transpose_leaf)
+    {
+        for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = i + 1; j != n; ++j)
+                std::swap(a[i * lda + j], a[j * lda + i]);
+        return;
+    }
+
+    const auto half = n / 2;
+    transpose_square(half, a, lda);
+    transpose_square(n - half, a + half * lda + half, lda);
+    transpose_swap(half, n - half, a + half, a + half * lda, lda);
+}
+
+// In-place transposition of a dense m x n row-major matrix into an n x m one.
+// Element i * n + j moves to j * m + i; the permutation is applied cycle by cycle,
+// and a bitmap of m * n bits marks the elements which have already been moved.
+template<typename T>
+void transpose_cycles(std::size_t m, std::size_t n, T *a)
+{
+    const auto size = m * n;
+    if (m <= 1 || n <= 1)
+        return;
+
+    std::vector<bool> moved(size);
+
+    // The first and the last elements stay where they are
+    for (std::size_t start = 1; start + 1 < size; ++start)
+    {
+        if (moved[start])
+            continue;
+
+        T carried = std::move(a[start]);
+        auto pos = start;
+        do
+        {
+            pos = (pos % n) * m + pos / n;
+            std::swap(carried, a[pos]);
+            moved[pos] = true;
+        }
+        while (pos != start);
+    }
+}
+
+} // namespace detail
+
+} // namespace yLab
+
+#endif // INCLUDE_TRANSPOSE_HPP
@@ -1,9 +1,13 @@
 #!/bin/bash
 
-# argv[1]: the algorithm of determinant calculation ("gauss" or "bareiss")
+# argv[1]: the algorithm of determinant calculation ("gauss", "bareiss" or "crt")
 # argv[2]: the number of matrices
 # argv[3]: the size of matrices
 # argv[4]: maximal absolute value of the determinant of matrices
+# argv[5], argv[6] (optional, in any order):
+#     "binary" to feed drivers with binary matrix files instead of text ones;
+#     "batch" to compute all determinants in one run of the driver rather than one run per matrix
+# SEED environment variable (optional): master seed of the generator, to reproduce a set of tests
 
 green="\033[1;32m"
 red="\033[1;31m"
@@ -14,6 +18,48 @@ build_dir="${top_dir}build/"
 
 test_generator="test_generator"
 
+# "crt" mode runs bareiss driver with multi-modular determinant engine
+function Driver_Target
+{
+    if [ $1 = "crt" ]
+    then
+        echo "bareiss"
+    else
+        echo $1
+    fi
+}
+
+function Driver_Flags
+{
+    local flags=""
+
+    if [ $1 = "crt" ]
+    then
+        flags="--crt"
+    fi
+
+    if [ ${format} = "binary" ]
+    then
+        flags="${flags} --binary"
+    fi
+
+    echo ${flags}
+}
+
+# Binary files hold elements of the type the driver computes with
+function Generator_Flags
+{
+    if [ ${format} = "binary" ]
+    then
+        if [ $1 = "gauss" ]
+        then
+            echo "--binary f64"
+        else
+            echo "--binary i64"
+        fi
+    fi
+}
+
 function Mkdir
 {
     rm -rf $1
@@ -31,7 +77,7 @@ function Build_Tests
     echo -en "\n"
 
     echo "Building test driver for ${det_alg} algorithm..."
-    cmake --build ${build_dir} --target ${det_alg}
+    cmake --build ${build_dir} --target $(Driver_Target ${det_alg})
     echo -en "\n"
 }
 
@@ -39,7 +85,9 @@ function Run_Tests
 {
     local det_alg=$1
     local test_generator="${build_dir}tests/end_to_end/${test_generator}"
-    local test_driver="${build_dir}tests/end_to_end/${det_alg}"
+    local test_driver="${build_dir}tests/end_to_end/$(Driver_Target ${det_alg})"
+    local driver_flags=$(Driver_Flags ${det_alg})
+    local generator_flags=$(Generator_Flags ${det_alg})
 
     local test_dir="tests_${det_alg}/"
     local ans_dir="answers_${det_alg}/"
@@ -49,16 +97,37 @@ function Run_Tests
     Mkdir ${ans_dir}
 
     echo "Generating tests and answers..."
-    ${test_generator} ${test_dir} ${ans_dir} ${n_matrices} ${size} ${det}
+    ${test_generator} ${test_dir} ${ans_dir} ${n_matrices} ${size} ${det} ${generator_flags} ${SEED:+--seed ${SEED}}
     echo -en "\n"
 
     Mkdir ${res_dir}
 
     echo "Testing..."
+    local start=$(date +%s%N)
+
+    if [ ${batch} = true ]
+    then
+        local test_files=()
+        for ((i = 1; i <= ${n_matrices}; i++))
+        do
+            test_files+=("${test_dir}test_${i}")
+        done
+
+        ${test_driver} ${driver_flags} --batch "${test_files[@]}" > ${res_dir}results
+
+        # Determinants are printed one per line in the order of the files
+        awk -v dir=${res_dir} '{ print > (dir "result_" NR) }' ${res_dir}results
+    else
+        for ((i = 1; i <= ${n_matrices}; i++))
+        do
+            ${test_driver} ${driver_flags} < ${test_dir}test_${i} > ${res_dir}result_${i}
+        done
+    fi
+
+    local finish=$(date +%s%N)
+
     for ((i = 1; i <= ${n_matrices}; i++))
     do
-        ${test_driver} < ${test_dir}test_${i} > ${res_dir}result_${i}
-
         echo -n "Test ${i}: "
         if diff -Z ${ans_dir}/answer_${i} ${res_dir}result_${i} > /dev/null
         then
@@ -67,15 +136,33 @@ function Run_Tests
             echo -e "${red}failed${default}"
         fi
     done
+
+    echo -en "\n"
+    awk -v n=${n_matrices} -v ns=$((finish - start)) \
+        'BEGIN { printf "Total time: %.3f s, throughput: %.1f matrices/s\n", ns / 1e9, n * 1e9 / ns }'
 }
 
-if [ $# -ne 4 ]
+format="text"
+batch=false
+for option in "${@:5}"
+do
+    case ${option} in
+        binary) format="binary" ;;
+        batch)  batch=true ;;
+        *)      unknown_option=${option} ;;
+    esac
+done
+
+if [ $# -lt 4 ] || [ $# -gt 6 ]
+then
+    echo "Testing script requires 4 arguments and up to 2 optional ones"
+elif [ -n "${unknown_option}" ]
 then
-    echo "Testing script requires exactly 3 arguments"
+    echo "There is no option with name ${unknown_option}"
 else
     det_alg=$1
 
-    if [ $det_alg = "gauss" ] || [ $det_alg = "bareiss" ]
+    if [ $det_alg = "gauss" ] || [ $det_alg = "bareiss" ] || [ $det_alg = "crt" ]
     then
         if [ $2 -le 0 ]
         then
@@ -1,27 +1,239 @@
+#include <chrono>
 #include <cstddef>
 #include <exception>
+#include <fstream>
 #include <iostream>
-#include <iterator>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
 
 #include "matrix.hpp"
+#include "matrix_file.hpp"
+#include "matrix_reader.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+
+#ifdef INTEGER
+#include "modular_det.hpp"
+#endif
+
+// Options:
+//   --binary: matrices are binary matrix files rather than text;
+//   --crt:    (bareiss only) multi-modular determinant;
+//   --batch:  many matrices are processed in one run. They are read either from the files
+//             given after the options or, if there are none, from standard input as a sequence
+//             of text matrices. Determinants are computed in parallel and printed one per line
+//             in the order of the input;
+//   --stats:  the time of reading matrices and the time of computations are printed on stderr.
+//             Builds with YLAB_STATS add statistics of the operations done by the library.
+
+#ifdef INTEGER
+using elem_type = long long;
+#else
+using elem_type = double;
+#endif
+
+using Matrix = yLab::Matrix<elem_type>;
+
+struct Options final
+{
+    bool binary = false;
+    bool use_crt = false;
+    bool batch = false;
+    bool stats = false;
+    std::vector<std::string> files;
+};
+
+using Clock = std::chrono::steady_clock;
+
+struct Timings final
+{
+    Clock::duration parse{};
+    Clock::duration compute{};
+};
+
+// Adds the time of func() to total and returns what func returns
+template<typename F>
+decltype(auto) timed(Clock::duration &total, F func)
+{
+    struct Timer final
+    {
+        Clock::duration &total;
+        Clock::time_point start = Clock::now();
+        ~Timer() { total += Clock::now() - start; }
+    } timer{total};
+
+    return func();
+}
+
+void print_stats(const Timings &timings)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::cerr << "Parse time: " << Milliseconds{timings.parse}.count() << " ms\n"
+              << "Compute time: " << Milliseconds{timings.compute}.count() << " ms\n";
+
+    if constexpr (yLab::stats::enabled)
+        std::cerr << yLab::stats::snapshot();
+}
+
+Options parse_options(int argc, char *argv[])
+{
+    Options options;
+
+    for (int arg_i = 1; arg_i != argc; ++arg_i)
+    {
+        const std::string_view arg{argv[arg_i]};
+
+        if (arg == "--binary")
+            options.binary = true;
+        else if (arg == "--batch")
+            options.batch = true;
+        else if (arg == "--stats")
+            options.stats = true;
+        #ifdef INTEGER
+        else if (arg == "--crt")
+            options.use_crt = true;
+        #endif
+        else if (options.batch && !arg.starts_with("--"))
+            options.files.emplace_back(arg);
+        else
+            throw std::runtime_error{"unknown option " + std::string{arg}};
+    }
+
+    if (options.batch && options.binary && options.files.empty())
+        throw std::runtime_error{"binary matrices can be processed in batch mode only from files"};
+
+    return options;
+}
 
-int main() try
+Matrix read_file(const std::string &path)
+{
+    std::ifstream file{path};
+    if (!file)
+        throw std::runtime_error{"cannot open " + path};
+
+    return yLab::read_matrix<elem_type>(file);
+}
+
+elem_type determinant(const Matrix &matrix, [[maybe_unused]] bool use_crt)
 {
     #ifdef INTEGER
-    using elem_type = long long;
-    #else
-    using elem_type = double;
+    if (use_crt)
+        return yLab::modular_determinant(matrix);
     #endif
 
-    std::size_t size;
-    std::cin >> size;
-    if (!std::cin.good())
-        throw std::runtime_error{"reading size of matrix failed"};
+    return matrix.determinant();
+}
+
+// Binary matrices are used right from the mapping: the elements are copied only once,
+// into the storage of elimination
+elem_type determinant(const yLab::Matrix_File &file, [[maybe_unused]] bool use_crt)
+{
+    #ifdef INTEGER
+    if (use_crt)
+        return yLab::modular_determinant(Matrix{file.view<elem_type>()});
+    #endif
+
+    return file.view<elem_type>().determinant();
+}
+
+// Matrices are read in windows of a few per thread, so that reading of a window
+// and computations on it don't need memory for the whole input
+void run_batch(const Options &options, Timings &timings)
+{
+    auto &pool = yLab::Thread_Pool::default_pool();
+    const std::size_t window = 4 * (pool.n_threads() + 1);
+
+    std::optional<yLab::Matrix_Reader> reader;
+    if (options.files.empty())
+        reader.emplace(std::cin);
+
+    const bool mapped = options.binary && !reader;
+
+    std::vector<Matrix> matrices;
+    std::vector<yLab::Matrix_File> files;
+    std::vector<elem_type> dets;
+    std::ostringstream output;
+    for (std::size_t first = 0;; first += dets.size())
+    {
+        matrices.clear();
+        files.clear();
+
+        timed(timings.parse, [&]
+        {
+            if (reader)
+            {
+                std::size_t size;
+                while (matrices.size() != window && reader->next(size))
+                    matrices.push_back(reader->read<elem_type>(size, size));
+            }
+            else
+            {
+                for (auto i = first; i != options.files.size() && i - first != window; ++i)
+                {
+                    if (mapped)
+                        files.emplace_back(options.files[i]);
+                    else
+                        matrices.push_back(read_file(options.files[i]));
+                }
+            }
+        });
+
+        dets.resize(mapped ? files.size() : matrices.size());
+        if (dets.empty())
+            break;
+
+        timed(timings.compute, [&]
+        {
+            pool.parallel_for(dets.size(), [&](std::size_t i)
+            {
+                dets[i] = mapped ? determinant(files[i], options.use_crt)
+                                 : determinant(matrices[i], options.use_crt);
+            });
+        });
+
+        for (auto det : dets)
+            output << det << '\n';
+        std::cout << output.str() << std::flush;
+        output.str({});
+    }
+}
+
+int main(int argc, char *argv[]) try
+{
+    const auto options = parse_options(argc, argv);
+    Timings timings;
+
+    if (options.batch)
+        run_batch(options, timings);
+    else
+    {
+        elem_type det;
+        if (options.binary)
+        {
+            // Standard input has to be redirected from a file to be mapped
+            const auto file = timed(timings.parse, [&]{ return yLab::Matrix_File{STDIN_FILENO}; });
+            det = timed(timings.compute, [&]{ return determinant(file, options.use_crt); });
+        }
+        else
+        {
+            const auto matrix = timed(timings.parse, [&]
+            {
+                return yLab::read_matrix<elem_type>(std::cin);
+            });
+            det = timed(timings.compute, [&]{ return determinant(matrix, options.use_crt); });
+        }
+        std::cout << det << std::endl;
+    }
 
-    yLab::Matrix<elem_type> matrix{size, size, std::istream_iterator<elem_type>{std::cin},
-                                   std::istream_iterator<elem_type>{}};
-    std::cout << matrix.determinant() << std::endl;
+    if (options.stats)
+        print_stats(timings);
 
     return 0;
 }
@@ -1,11 +1,113 @@
+#include <charconv>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <string>
+#include <exception>
 #include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "matrix.hpp"
+#include "matrix_file.hpp"
 #include "random_matrix.hpp"
+#include "thread_pool.hpp"
+
+// Usage: test_generator test_dir ans_dir n_matrices size max_det [options]
+// Options:
+//   --binary i64|f64: write binary matrix files of elements of the given type
+//                     ("i64" for bareiss driver, "f64" for gauss driver) instead of text;
+//   --seed S:         master seed. Every matrix has a seed of its own derived from it,
+//                     so a set of tests can be reproduced. Random if omitted.
+// Matrices are generated in parallel; YLAB_NUM_THREADS environment variable limits the number
+// of threads.
+
+enum class Format
+{
+    text,
+    binary_i64,
+    binary_f64
+};
+
+struct Options final
+{
+    Format format = Format::text;
+    std::uint64_t seed = std::random_device{}() ^ (std::uint64_t{std::random_device{}()} << 32);
+};
+
+Options parse_options (int argc, char *argv[])
+{
+    Options options;
+
+    for (auto arg_i = 6; arg_i < argc; ++arg_i)
+    {
+        const std::string_view arg {argv[arg_i]};
+        if (arg_i + 1 == argc)
+            throw std::runtime_error {"option " + std::string{arg} + " requires a value"};
+        const std::string_view value {argv[++arg_i]};
+
+        if (arg == "--binary" && value == "i64")
+            options.format = Format::binary_i64;
+        else if (arg == "--binary" && value == "f64")
+            options.format = Format::binary_f64;
+        else if (arg == "--seed")
+        {
+            auto [ptr, ec] = std::from_chars (value.data(), value.data() + value.size(), options.seed);
+            if (ec != std::errc{} || ptr != value.data() + value.size())
+                throw std::runtime_error {"invalid seed " + std::string{value}};
+        }
+        else
+            throw std::runtime_error {"unknown option " + std::string{arg} + " " + std::string{value}};
+    }
+
+    return options;
+}
+
+// The whole file is formatted in memory and written at once
+void write_text (const std::string &path, const yLab::Matrix<long long> &matrix)
+{
+    const auto size = matrix.n_rows();
+
+    std::string buffer;
+    buffer.reserve (32 + size * size * 8);
+
+    char number[24];
+    auto append = [&](auto value, char separator)
+    {
+        auto end = std::to_chars (number, number + sizeof (number), value).ptr;
+        *end++ = separator;
+        buffer.append (number, end);
+    };
+
+    append (size, '\n');
+    for (std::size_t i = 0; i != size; ++i)
+        for (std::size_t j = 0; j != size; ++j)
+            append (matrix[i][j], (j + 1 == size) ? '\n' : ' ');
 
-int main (int argc, char *argv[])
+    std::ofstream file {path, std::ios::binary};
+    file.write (buffer.data(), buffer.size());
+    if (!file)
+        throw std::runtime_error {"writing " + path + " failed"};
+}
+
+template<typename T>
+void write_binary (const std::string &path, const yLab::Matrix<T> &matrix)
 {
+    std::ofstream file {path, std::ios::binary};
+    yLab::write_binary (file, matrix);
+}
+
+int main (int argc, char *argv[]) try
+{
+    if (argc < 6)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " test_dir ans_dir n_matrices size max_det [--binary i64|f64] [--seed S]\n";
+        return 1;
+    }
+
     std::string test_dir {argv[1], strlen (argv[1])};
     std::string ans_dir  {argv[2], strlen (argv[2])};
 
@@ -13,30 +115,41 @@ int main (int argc, char *argv[])
     size_t size    = std::atoi (argv[4]);
     int max_det    = std::atoi (argv[5]);
 
-    std::random_device rd;
-    std::mt19937_64 gen (rd());
-    std::uniform_int_distribution<int> det (-max_det, max_det);
+    const auto options = parse_options (argc, argv);
+    std::cout << "Master seed: " << options.seed << std::endl;
 
-    for (auto i = 1; i <= n_matrices; ++i)
+    auto generate = [&](std::size_t index)
     {
-        auto actual_det = det (gen);
-        yLab::Random_Matrix<int> matrix {size, actual_det};
+        std::mt19937_64 gen {yLab::random_matrix_seed (options.seed, index)};
+        std::uniform_int_distribution<int> det (-max_det, max_det);
+        const auto actual_det = det (gen);
 
-        auto test_i = std::to_string (i);
+        auto test_i = std::to_string (index + 1);
+        auto test_name = test_dir + "test_" + test_i;
 
-        std::string test_name {"test_"};
-        test_name += test_i;
-        std::ofstream test_file {test_dir + test_name};
+        switch (options.format)
+        {
+            case Format::text:
+                write_text (test_name, yLab::random_matrix<long long> (size, actual_det, gen));
+                break;
+            case Format::binary_i64:
+                write_binary (test_name, yLab::random_matrix<long long> (size, actual_det, gen));
+                break;
+            case Format::binary_f64:
+                write_binary (test_name, yLab::random_matrix<double> (size, actual_det, gen));
+                break;
+        }
 
-        test_file << size << std::endl;
-        test_file << matrix;
+        std::ofstream ans_file {ans_dir + "answer_" + test_i};
+        ans_file << actual_det << '\n';
+    };
 
-        std::string ans_name {"answer_"};
-        ans_name += test_i;
-        std::ofstream ans_file {ans_dir + ans_name};
-
-        ans_file << actual_det << std::endl;
-    }
+    yLab::Thread_Pool::default_pool().parallel_for (n_matrices, generate);
 
     return 0;
 }
+catch (const std::exception &e)
+{
+    std::cerr << "Caught an instance of " << typeid(e).name() << "\nwhat(): " << e.what() << '\n';
+    return 1;
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "lu.hpp"
+#include "matrix.hpp"
+
+namespace
+{
+
+// Counts the bytes allocated through it and refuses to fall back to the heap
+class Arena final
+{
+public:
+
+    Arena() { old_default_ = std::pmr::set_default_resource (std::pmr::null_memory_resource()); }
+    ~Arena() { std::pmr::set_default_resource (old_default_); }
+
+    std::pmr::memory_resource *resource() { return &arena_; }
+
+private:
+
+    std::array<std::byte, 1 << 16> buffer_;
+    std::pmr::monotonic_buffer_resource arena_{buffer_.data(), buffer_.size(),
+                                               std::pmr::null_memory_resource()};
+    std::pmr::memory_resource *old_default_;
+};
+
+} // unnamed namespace
+
+TEST (Allocators, Pmr_Determinant)
+{
+    Arena arena;
+
+    yLab::pmr::Matrix<double> m ({{0, 2, 1},
+                                  {3, 1, 4},
+                                  {1, 5, 9}}, arena.resource());
+    EXPECT_EQ (m.get_allocator().resource(), arena.resource());
+    EXPECT_NEAR (m.determinant(), -32.0, 1e-12);
+
+    yLab::pmr::Matrix<long long> m_int ({{0, 2, 1},
+                                         {3, 1, 4},
+                                         {1, 5, 9}}, arena.resource());
+    EXPECT_EQ (m_int.determinant(), -32);
+
+    auto lu = m.lu();
+    auto inverse = lu.inverse();
+    EXPECT_EQ (inverse.get_allocator().resource(), arena.resource());
+}
+
+TEST (Allocators, Pmr_Arithmetics)
+{
+    Arena arena;
+
+    yLab::pmr::Matrix<int> a ({{1, 2},
+                               {3, 4}}, arena.resource());
+    yLab::pmr::Matrix<int> b ({{5, 6},
+                               {7, 8}}, arena.resource());
+
+    yLab::pmr::Matrix<int> sum {a + b, arena.resource()};
+    EXPECT_TRUE (sum == (yLab::Matrix<int>{{6, 8}, {10, 12}}));
+
+    // The result reuses the storage of the rvalue operand along with its allocator
+    yLab::pmr::Matrix<int> diff = std::move (sum) - a;
+    EXPECT_EQ (diff.get_allocator().resource(), arena.resource());
+    EXPECT_TRUE (diff == b);
+
+    auto prod = product (a, b);
+    EXPECT_EQ (prod.get_allocator().resource(), arena.resource());
+    EXPECT_TRUE (prod == (yLab::Matrix<int>{{19, 22}, {43, 50}}));
+
+    yLab::pmr::Matrix<int> copy {a, arena.resource()};
+    copy = b;
+    EXPECT_EQ (copy.get_allocator().resource(), arena.resource());
+    EXPECT_TRUE (copy == b);
+
+    a.transpose();
+    EXPECT_TRUE (a == (yLab::Matrix<int>{{1, 3}, {2, 4}}));
+}
+
+TEST (Allocators, Move_Between_Resources)
+{
+    std::pmr::monotonic_buffer_resource other;
+    yLab::pmr::Matrix<int> a ({{1, 2},
+                               {3, 4}}, &other);
+
+    Arena arena;
+    yLab::pmr::Matrix<int> b {2, 2, 0, arena.resource()};
+
+    // Allocators don't propagate, so the elements are copied into the arena
+    b = std::move (a);
+    EXPECT_EQ (b.get_allocator().resource(), arena.resource());
+    EXPECT_TRUE (b == (yLab::Matrix<int>{{1, 2}, {3, 4}}));
+}
+
+TEST (Allocators, Aligned_Rows)
+{
+    yLab::Matrix<double> plain {5, 7};
+    for (std::size_t i = 0; i != plain.n_rows(); ++i)
+        for (std::size_t j = 0; j != plain.n_cols(); ++j)
+            plain[i][j] = static_cast<double>((i * 7 + j * 3) % 11) - 5.0;
+
+    yLab::Aligned_Matrix<double> aligned {5, 7};
+    aligned = plain;
+
+    EXPECT_EQ (plain.stride(), 7);
+    EXPECT_EQ (aligned.stride(), 8);
+    for (std::size_t i = 0; i != aligned.n_rows(); ++i)
+        EXPECT_EQ (reinterpret_cast<std::uintptr_t>(&aligned[i][0]) % 64, 0);
+
+    EXPECT_TRUE (aligned == plain);
+    EXPECT_TRUE (aligned == yLab::Aligned_Matrix<double>{aligned});
+
+    yLab::Aligned_Matrix<double> aligned_t = aligned;
+    aligned_t.transpose();
+    yLab::Matrix<double> plain_t = plain;
+    plain_t.transpose();
+    EXPECT_EQ (aligned_t.stride(), 8);
+    EXPECT_TRUE (aligned_t == plain_t);
+
+    auto prod = product (aligned, aligned_t);
+    EXPECT_TRUE (prod == product (plain, plain_t));
+    EXPECT_NEAR (prod.determinant(), product (plain, plain_t).determinant(), 1e-6);
+
+    auto inverse = prod.lu().inverse();
+    auto identity = product (prod, inverse);
+    for (std::size_t i = 0; i != identity.n_rows(); ++i)
+        for (std::size_t j = 0; j != identity.n_cols(); ++j)
+            EXPECT_NEAR (identity[i][j], (i == j) ? 1.0 : 0.0, 1e-9);
+}
+
+// Matrices whose elements are written by the caller still get their padding initialized
+TEST (Allocators, Aligned_Padding)
+{
+    yLab::Aligned_Matrix<double> m {5, 7, 1.0};
+
+    yLab::Aligned_Matrix<double> sum = m + m;
+    auto transposed = m;
+    transposed.transpose();
+
+    for (const auto *matrix : {&sum, &transposed})
+    {
+        const auto &elems = *matrix;
+        ASSERT_NE (elems.stride(), elems.n_cols());
+        for (std::size_t i = 0; i != elems.n_rows(); ++i)
+            for (std::size_t j = elems.n_cols(); j != elems.stride(); ++j)
+                EXPECT_EQ (elems.data()[i * elems.stride() + j], 0.0);
+    }
+}
+
+TEST (Allocators, Aligned_Integer_Determinant)
+{
+    const int elems[] = {0, 2, 1, 3, 1, 4, 1, 5, 9};
+    yLab::Aligned_Matrix<long long> m {3, 3, std::begin (elems), std::end (elems)};
+
+    EXPECT_EQ (m.stride(), 8);
+    EXPECT_EQ (m[2][1], 5);
+    EXPECT_EQ (m.determinant(), -32);
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <tuple>
+
 #include "matrix.hpp"
 
 TEST (Arithmetics, Sum)
@@ -86,3 +88,104 @@ TEST (Arithmetics, Product)
 
     EXPECT_TRUE (product (first, second) == result);
 }
+
+TEST (Arithmetics, Blocked_Product)
+{
+    constexpr std::size_t m = 131, k = 277, n = 263;
+
+    yLab::Matrix<long long> first {m, k};
+    yLab::Matrix<long long> second {k, n};
+    for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != k; ++j)
+            first[i][j] = static_cast<long long>((i * 7 + j * 3) % 19) - 9;
+    for (std::size_t i = 0; i != k; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+            second[i][j] = static_cast<long long>((i * 5 + j * 11) % 23) - 11;
+
+    yLab::Matrix<long long> expected {m, n};
+    for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+            for (std::size_t p = 0; p != k; ++p)
+                expected[i][j] += first[i][p] * second[p][j];
+
+    EXPECT_TRUE (product (first, second) == expected);
+
+    yLab::Matrix<double> first_d {m, k, first.begin(), first.end()};
+    yLab::Matrix<double> second_d {k, n, second.begin(), second.end()};
+    auto product_d = product (first_d, second_d);
+    for (std::size_t i = 0; i != m; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+            EXPECT_DOUBLE_EQ (product_d[i][j], static_cast<double>(expected[i][j]));
+}
+
+TEST (Arithmetics, Parallel_Product)
+{
+    yLab::Thread_Pool pool {4};
+
+    for (auto [m, k, n] : {std::tuple{300, 70, 20}, std::tuple{257, 129, 301}, std::tuple{5, 64, 1000}})
+    {
+        yLab::Matrix<int> first {static_cast<std::size_t>(m), static_cast<std::size_t>(k)};
+        yLab::Matrix<int> second {static_cast<std::size_t>(k), static_cast<std::size_t>(n)};
+        for (std::size_t i = 0; auto &elem : first)
+            elem = static_cast<int>(i++ % 13) - 6;
+        for (std::size_t i = 0; auto &elem : second)
+            elem = static_cast<int>(i++ % 7) - 3;
+
+        auto expected = product (yLab::execution::seq, first, second);
+        EXPECT_TRUE (product (yLab::execution::par.on (pool), first, second) == expected);
+        EXPECT_TRUE (product (yLab::execution::par, first, second) == expected);
+    }
+}
+
+TEST (Arithmetics, Chained_Expression)
+{
+    yLab::Matrix<int> a = {{1, 2},
+                           {3, 4}};
+    yLab::Matrix<int> b = {{5, 6},
+                           {7, 8}};
+    yLab::Matrix<int> c = {{1, 1},
+                           {2, 2}};
+
+    yLab::Matrix<int> result = a + b - 2 * c;
+    yLab::Matrix<int> expected = {{4, 6},
+                                  {6, 8}};
+    EXPECT_TRUE (result == expected);
+    EXPECT_TRUE ((a + b) / 2 == (yLab::Matrix<int>{{3, 4}, {5, 6}}));
+
+    yLab::Matrix<int> d {3, 3};
+    EXPECT_THROW (a + d, yLab::Undef_Sum);
+    EXPECT_THROW (a - d, yLab::Undef_Diff);
+}
+
+TEST (Arithmetics, Rvalue_Storage_Reuse)
+{
+    yLab::Matrix<double> a = {{1, 2},
+                              {3, 4}};
+    yLab::Matrix<double> b = {{5, 6},
+                              {7, 8}};
+
+    auto tmp = a * 3.0;
+    yLab::Matrix<double> tmp_matrix = tmp;
+    const double *storage = tmp_matrix.data();
+
+    yLab::Matrix<double> result = std::move (tmp_matrix) + b - a;
+    EXPECT_EQ (result.data(), storage);
+    EXPECT_TRUE (result == (yLab::Matrix<double>{{7, 10}, {13, 16}}));
+}
+
+TEST (Arithmetics, Aliased_Assignment)
+{
+    yLab::Matrix<int> a = {{1, 2},
+                           {3, 4}};
+    const int *storage = a.data();
+
+    a = a + a * 2;
+    EXPECT_EQ (a.data(), storage);
+    EXPECT_TRUE (a == (yLab::Matrix<int>{{3, 6}, {9, 12}}));
+
+    a += a - 1 * a;
+    EXPECT_TRUE (a == (yLab::Matrix<int>{{3, 6}, {9, 12}}));
+
+    a -= a / 3;
+    EXPECT_TRUE (a == (yLab::Matrix<int>{{2, 4}, {6, 8}}));
+}
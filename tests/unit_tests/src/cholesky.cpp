@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "cholesky.hpp"
+#include "common.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+// Elements of A / 9 are in [-1; 1], so (A / 9) * (A / 9)^T / n + I is symmetric positive
+// definite, and its eigenvalues are close to 1
+yLab::Matrix<double> gram_matrix (std::size_t n)
+{
+    const auto a = test::random_matrix<double> (n, n);
+
+    yLab::Matrix<double> gram = product (a, yLab::Matrix<double> (a.transposed()));
+    gram /= 81.0 * static_cast<double>(n);
+    for (std::size_t i = 0; i != n; ++i)
+        gram[i][i] += 1.0;
+    return gram;
+}
+
+} // unnamed namespace
+
+TEST (Cholesky, Determinant)
+{
+    yLab::Matrix<double> m = {{4, 2, 2},
+                              {2, 5, 3},
+                              {2, 3, 6}};
+
+    auto cholesky = m.cholesky();
+    EXPECT_NEAR (cholesky.determinant(), 64.0, 1e-12);
+    EXPECT_NEAR (cholesky.log_determinant(), std::log (64.0), 1e-12);
+    EXPECT_NEAR (m.determinant(), 64.0, 1e-12);
+
+    auto l = cholesky.factor();
+    EXPECT_EQ (l[0][1], 0.0);
+    EXPECT_NEAR (l[0][0], 2.0, 1e-12);
+    EXPECT_NEAR (l[1][0], 1.0, 1e-12);
+    EXPECT_NEAR (l[2][1], 1.0, 1e-12);
+    EXPECT_NEAR (l[2][2], 2.0, 1e-12);
+
+    // Several panels, so the trailing updates are exercised
+    for (std::size_t n : {63, 64, 65, 200})
+    {
+        const auto gram = gram_matrix (n);
+        const auto expected = gram.lu().determinant();
+        EXPECT_NEAR (gram.cholesky().determinant(), expected, 1e-10 * std::abs (expected));
+        EXPECT_NEAR (gram.determinant(), expected, 1e-10 * std::abs (expected));
+    }
+}
+
+// Blocks of 48 rows don't divide 600, and the pool has several threads
+TEST (Cholesky, Blocked)
+{
+    constexpr std::size_t n = 600;
+    const auto gram = gram_matrix (n);
+
+    auto unblocked = gram;
+    ASSERT_TRUE (yLab::detail::cholesky_decompose (n, unblocked.data(), unblocked.stride()));
+
+    yLab::Thread_Pool pool {3};
+    auto blocked = gram;
+    ASSERT_TRUE (yLab::detail::cholesky_decompose (pool, n, blocked.data(), blocked.stride(), 48));
+
+    for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = i; j != n; ++j)
+            ASSERT_NEAR (blocked[i][j], unblocked[i][j], 1e-12) << i << ' ' << j;
+
+    // The strictly lower triangle keeps A
+    for (std::size_t i = 1; i != n; ++i)
+        for (std::size_t j = 0; j != i; ++j)
+            ASSERT_EQ (blocked[i][j], gram[i][j]) << i << ' ' << j;
+
+    auto indefinite = gram;
+    indefinite[500][500] = -1.0;
+    EXPECT_FALSE (yLab::detail::cholesky_decompose (pool, n, indefinite.data(), indefinite.stride(), 48));
+}
+
+// The determinant of a 400 x 400 matrix scaled by 1024 (exactly) overflows double,
+// while its logarithm doesn't
+TEST (Cholesky, Log_Determinant)
+{
+    constexpr std::size_t n = 400;
+    const auto gram = gram_matrix (n);
+
+    auto scaled = gram;
+    scaled *= 1024.0;
+    const auto cholesky = scaled.cholesky();
+    EXPECT_TRUE (std::isinf (cholesky.determinant()));
+
+    const auto expected = std::log (gram.lu().determinant()) + n * std::log (1024.0);
+    EXPECT_NEAR (cholesky.log_determinant(), expected, 1e-10 * expected);
+}
+
+TEST (Cholesky, Solve)
+{
+    const auto gram = gram_matrix (100);
+    const auto cholesky = gram.cholesky();
+
+    std::vector<double> b (100);
+    for (std::size_t i = 0; i != b.size(); ++i)
+        b[i] = std::cos (static_cast<double>(i));
+
+    const auto x = cholesky.solve (b);
+    const auto x_lu = gram.lu().solve (b);
+    for (std::size_t i = 0; i != x.size(); ++i)
+        EXPECT_NEAR (x[i], x_lu[i], 1e-12);
+
+    const auto rhs = yLab::Matrix<double> {100, 3, b.begin(), b.end()};
+    const auto solution = cholesky.solve (rhs);
+    const auto residual = product (gram, solution);
+    for (std::size_t i = 0; i != 100; ++i)
+        for (std::size_t j = 0; j != 3; ++j)
+            EXPECT_NEAR (residual[i][j], rhs[i][j], 1e-10);
+
+    EXPECT_THROW (cholesky.solve (std::vector<double>(99)), yLab::Undef_Solve);
+}
+
+// Symmetric matrices which aren't positive definite fall back to Gauss algorithm
+TEST (Cholesky, Not_Positive_Definite)
+{
+    yLab::Matrix<double> indefinite = {{1, 2, 0},
+                                       {2, 1, 0},
+                                       {0, 0, 3}};
+    EXPECT_THROW (indefinite.cholesky(), yLab::Not_Positive_Definite);
+    EXPECT_NEAR (indefinite.determinant(), -9.0, 1e-12);
+
+    yLab::Matrix<double> singular = {{1, 1},
+                                     {1, 1}};
+    EXPECT_THROW (singular.cholesky(), yLab::Not_Positive_Definite);
+    EXPECT_EQ (singular.determinant(), 0.0);
+
+    // A negative diagonal element rejects the matrix before the decomposition
+    auto gram = gram_matrix (130);
+    gram[129][129] = -1000.0;
+    EXPECT_THROW (gram.cholesky(), yLab::Not_Positive_Definite);
+    EXPECT_NEAR (gram.determinant(), gram.lu().determinant(), 1e-10 * std::abs (gram.lu().determinant()));
+
+    // The diagonal is positive, and the last leading minor is the only negative one: elimination
+    // starts over in the storage of the failed decomposition
+    auto coupled = gram_matrix (130);
+    coupled[128][129] = coupled[129][128] = 10.0;
+    EXPECT_THROW (coupled.cholesky(), yLab::Not_Positive_Definite);
+    const auto expected = coupled.lu().determinant();
+    ASSERT_LT (expected, 0.0);
+    EXPECT_NEAR (coupled.determinant(), expected, 1e-10 * std::abs (expected));
+
+    EXPECT_THROW ((yLab::Matrix<double> {2, 3}.cholesky()), yLab::Undef_Cholesky);
+}
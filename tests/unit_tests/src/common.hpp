@@ -0,0 +1,43 @@
+#ifndef UNIT_TESTS_COMMON_HPP
+#define UNIT_TESTS_COMMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "matrix.hpp"
+
+namespace test
+{
+
+// Elements are integers uniformly distributed in [-9; 9] whatever T is, so sums and products
+// of floating point matrices are exact
+template<typename T>
+yLab::Matrix<T> random_matrix (std::size_t n_rows, std::size_t n_cols, std::uint64_t seed = 42)
+{
+    std::mt19937_64 gen {seed};
+    std::uniform_int_distribution<int> dist {-9, 9};
+
+    yLab::Matrix<T> matrix {n_rows, n_cols};
+    for (std::size_t i = 0; i != n_rows; ++i)
+        for (std::size_t j = 0; j != n_cols; ++j)
+            matrix[i][j] = static_cast<T>(dist (gen));
+
+    return matrix;
+}
+
+// Elements off the diagonal are in [-1; 1], and shift is added to the diagonal ones.
+// The larger the shift against sqrt(n), the smaller the condition number.
+inline yLab::Matrix<double> well_conditioned (std::size_t n, double shift, std::uint64_t seed = 42)
+{
+    auto matrix = random_matrix<double> (n, n, seed);
+    matrix /= 9.0;
+    for (std::size_t i = 0; i != n; ++i)
+        matrix[i][i] += shift;
+
+    return matrix;
+}
+
+} // namespace test
+
+#endif // UNIT_TESTS_COMMON_HPP
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <utility>
+
+#include "matrix.hpp"
+
+TEST (Determinant_Cache, Disabled)
+{
+    if constexpr (yLab::detail::determinant_cache_enabled)
+        GTEST_SKIP() << "The cache is enabled";
+
+    // The member takes no space in Matrix
+    static_assert (std::is_empty_v<yLab::detail::Determinant_Cache<double, false>>);
+
+    yLab::Matrix<double> m = {{1, 2}, {3, 4}};
+    EXPECT_DOUBLE_EQ (m.determinant(), -2);
+    m[0][0] = 2;
+    EXPECT_DOUBLE_EQ (m.determinant(), 2);
+}
+
+TEST (Determinant_Cache, Modifications)
+{
+    if constexpr (!yLab::detail::determinant_cache_enabled)
+        GTEST_SKIP() << "The cache is compiled out: configure with -DYLAB_DET_CACHE=ON";
+    else
+    {
+        yLab::Matrix<double> m = {{1, 2}, {3, 4}};
+        EXPECT_DOUBLE_EQ (m.determinant(), -2);
+
+        // Reads of a const matrix don't change the generation
+        const auto generation = m.generation();
+        const auto &c_m = m;
+        EXPECT_EQ (c_m[1][1], 4);
+        EXPECT_DOUBLE_EQ (c_m.determinant(), -2);
+        EXPECT_EQ (m.generation(), generation);
+
+        m[0][0] = 2;
+        EXPECT_GT (m.generation(), generation);
+        EXPECT_DOUBLE_EQ (m.determinant(), 2);
+
+        *m.begin() = 1;
+        EXPECT_DOUBLE_EQ (m.determinant(), -2);
+
+        m.data()[m.stride() + 1] = 10;
+        EXPECT_DOUBLE_EQ (m.determinant(), 4);
+
+        m.view()[1][1] = 6;
+        EXPECT_DOUBLE_EQ (m.determinant(), 0);
+
+        m *= 2.0;
+        EXPECT_DOUBLE_EQ (m.determinant(), 0);
+        m[1][1] = 8;
+        EXPECT_DOUBLE_EQ (m.determinant(), -8);
+
+        m += yLab::Matrix<double>::identity_matrix (2, 2);
+        EXPECT_DOUBLE_EQ (m.determinant(), 3 * 9 - 4 * 6);
+
+        m = m - m;
+        EXPECT_DOUBLE_EQ (m.determinant(), 0);
+
+        yLab::Matrix<long long> i_m = {{0, 1, 2},
+                                       {3, 4, 5},
+                                       {6, 7, 9}};
+        EXPECT_EQ (i_m.determinant(), -3);
+        i_m.transpose();
+        EXPECT_EQ (i_m.determinant(), -3);
+        i_m[2][2] = 8;
+        EXPECT_EQ (i_m.determinant(), 0);
+    }
+}
+
+TEST (Determinant_Cache, Copies)
+{
+    if constexpr (!yLab::detail::determinant_cache_enabled)
+        GTEST_SKIP() << "The cache is compiled out: configure with -DYLAB_DET_CACHE=ON";
+    else
+    {
+        yLab::Matrix<double> m = {{1, 2}, {3, 4}};
+        EXPECT_DOUBLE_EQ (m.determinant(), -2);
+
+        // The copy has the same elements, so it takes the value, but counts modifications apart
+        auto copy = m;
+        copy[0][0] = 0;
+        EXPECT_DOUBLE_EQ (copy.determinant(), -6);
+        EXPECT_DOUBLE_EQ (m.determinant(), -2);
+
+        const auto generation = copy.generation();
+        copy = m;
+        EXPECT_GT (copy.generation(), generation);
+        EXPECT_DOUBLE_EQ (copy.determinant(), -2);
+
+        // A moved-from matrix doesn't keep the value of its former elements
+        auto moved = std::move (m);
+        EXPECT_DOUBLE_EQ (moved.determinant(), -2);
+        m = yLab::Matrix<double> {{5, 0}, {0, 5}};
+        EXPECT_DOUBLE_EQ (m.determinant(), 25);
+
+        // The result of a wrong hint isn't cached
+        const yLab::Matrix<double> general = {{1, 2}, {3, 4}};
+        EXPECT_DOUBLE_EQ (general.determinant (yLab::structure::Diagonal{}), 4);
+        EXPECT_DOUBLE_EQ (general.determinant(), -2);
+        EXPECT_DOUBLE_EQ (general.determinant (yLab::structure::Diagonal{}), -2);
+    }
+}
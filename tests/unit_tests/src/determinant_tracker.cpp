@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "determinant_tracker.hpp"
+#include "lu.hpp"
+
+namespace
+{
+
+std::vector<double> test_vector (std::size_t n, double phase)
+{
+    std::vector<double> v (n);
+    for (std::size_t i = 0; i != n; ++i)
+        v[i] = std::cos (static_cast<double>(i) + phase);
+    return v;
+}
+
+void expect_determinant (const yLab::Determinant_Tracker<double> &tracker)
+{
+    const auto expected = tracker.matrix().lu().determinant();
+    EXPECT_NEAR (tracker.determinant(), expected, 1e-9 * std::abs (expected));
+}
+
+} // unnamed namespace
+
+TEST (Determinant_Tracker, Rank_One_Update)
+{
+    constexpr std::size_t n = 40;
+    yLab::Determinant_Tracker tracker {test::well_conditioned (n, 2.0)};
+    expect_determinant (tracker);
+
+    for (int k = 0; k != 10; ++k)
+    {
+        const auto u = test_vector (n, k);
+        const auto v = test_vector (n, 0.5 * k + 3);
+
+        auto expected = tracker.matrix();
+        for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                expected[i][j] += u[i] * v[j];
+
+        // The kernel may round u[i] * v[j] differently from the loop above
+        tracker.rank_one_update (u, v);
+        for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                ASSERT_NEAR (tracker.matrix()[i][j], expected[i][j],
+                             1e-14 * std::max (1.0, std::abs (expected[i][j])));
+        expect_determinant (tracker);
+    }
+
+    EXPECT_EQ (tracker.n_updates(), 10);
+    EXPECT_THROW (tracker.rank_one_update (std::vector<double>(n), std::vector<double>(n + 1)),
+                  yLab::Undef_Update);
+}
+
+TEST (Determinant_Tracker, Replace_Row_And_Column)
+{
+    constexpr std::size_t n = 30;
+    yLab::Determinant_Tracker tracker {test::well_conditioned (n, 2.0)};
+
+    for (std::size_t k = 0; k != 20; ++k)
+    {
+        const auto new_line = test_vector (n, static_cast<double>(k) * 0.7);
+        if (k % 2 == 0)
+        {
+            tracker.replace_row (k, new_line);
+            for (std::size_t j = 0; j != n; ++j)
+                EXPECT_EQ (tracker.matrix()[k][j], new_line[j]);
+        }
+        else
+        {
+            tracker.replace_column (k, new_line);
+            for (std::size_t i = 0; i != n; ++i)
+                EXPECT_EQ (tracker.matrix()[i][k], new_line[i]);
+        }
+        expect_determinant (tracker);
+    }
+
+    EXPECT_THROW (tracker.replace_row (n, std::vector<double>(n)), yLab::Undef_Update);
+    EXPECT_THROW (tracker.replace_column (0, std::vector<double>(n - 1)), yLab::Undef_Update);
+}
+
+// Periodic refactorization resets the count of updates
+TEST (Determinant_Tracker, Refactor_Interval)
+{
+    constexpr std::size_t n = 10;
+    yLab::Determinant_Tracker tracker {test::well_conditioned (n, 2.0), 4};
+
+    for (std::size_t k = 0; k != 10; ++k)
+    {
+        // Keeps the diagonal dominance, so that no update is close to singular
+        auto new_row = test_vector (n, static_cast<double>(k));
+        new_row[k % n] += 10.0;
+
+        tracker.replace_row (k % n, new_row);
+        EXPECT_EQ (tracker.n_updates(), (k + 1) % 4);
+        expect_determinant (tracker);
+    }
+}
+
+// Updates through singular matrices
+TEST (Determinant_Tracker, Singular)
+{
+    yLab::Matrix<double> m = {{1, 2, 3},
+                              {4, 5, 6},
+                              {7, 8, 10}};
+    yLab::Determinant_Tracker tracker {m};
+    EXPECT_NEAR (tracker.determinant(), -3.0, 1e-12);
+
+    EXPECT_EQ (tracker.replace_row (2, std::vector<double>{1, 2, 3}), 0.0);
+    EXPECT_TRUE (tracker.is_singular());
+    EXPECT_EQ (tracker.n_updates(), 0);
+
+    EXPECT_NEAR (tracker.replace_row (2, std::vector<double>{0, 0, 1}), -3.0, 1e-12);
+    EXPECT_FALSE (tracker.is_singular());
+
+    EXPECT_NEAR (tracker.rank_one_update (std::vector<double>{0, 0, 1}, std::vector<double>{0, 0, 1}),
+                 -6.0, 1e-12);
+    EXPECT_EQ (tracker.n_updates(), 1);
+
+    EXPECT_THROW ((yLab::Determinant_Tracker {yLab::Matrix<double> {2, 3}}), yLab::Undef_Det);
+}
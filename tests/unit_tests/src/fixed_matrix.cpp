@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+
+#include "common.hpp"
+#include "fixed_matrix.hpp"
+#include "matrix.hpp"
+
+using yLab::Fixed_Matrix;
+
+namespace
+{
+
+template<typename T, std::size_t N>
+Fixed_Matrix<T, N, N> test_matrix (std::size_t seed)
+{
+    return Fixed_Matrix<T, N, N>{test::random_matrix<T> (N, N, seed)};
+}
+
+} // unnamed namespace
+
+TEST (Fixed_Matrix, Constexpr)
+{
+    constexpr Fixed_Matrix<int, 2, 3> first = {{1, 2, 3},
+                                               {4, 5, 6}};
+    constexpr Fixed_Matrix<int, 3, 2> second = {{1, 0},
+                                                {0, 1},
+                                                {1, 1}};
+    constexpr Fixed_Matrix<int, 2, 2> expected = {{4, 5},
+                                                  {10, 11}};
+
+    static_assert (product (first, second) == expected);
+    static_assert (first.transposed() == Fixed_Matrix<int, 3, 2>{{1, 4}, {2, 5}, {3, 6}});
+    static_assert (expected.determinant() == -6);
+    static_assert (Fixed_Matrix<int, 5, 5>::identity_matrix().determinant() == 1);
+    static_assert ((expected + expected - expected) * 2 == expected * 2);
+    static_assert (sizeof (Fixed_Matrix<double, 4, 4>) == 16 * sizeof (double));
+}
+
+TEST (Fixed_Matrix, Il_Il_Ctor_Fail)
+{
+    using Matrix = Fixed_Matrix<int, 2, 2>;
+
+    EXPECT_THROW ((Matrix {{1, 2}, {3}}), yLab::Il_Il_Ctor_Fail);
+    EXPECT_THROW ((Matrix {{1, 2}}), yLab::Il_Il_Ctor_Fail);
+}
+
+TEST (Fixed_Matrix, Determinant)
+{
+    auto check = [] <std::size_t N> (std::integral_constant<std::size_t, N>)
+    {
+        for (std::size_t seed = 0; seed != 4; ++seed)
+        {
+            auto fixed = test_matrix<long long, N> (seed);
+            EXPECT_EQ (fixed.determinant(), fixed.to_matrix().determinant()) << "N = " << N;
+
+            auto fixed_d = test_matrix<double, N> (seed);
+            EXPECT_NEAR (fixed_d.determinant(), fixed_d.to_matrix().determinant(), 1e-9) << "N = " << N;
+        }
+    };
+
+    check (std::integral_constant<std::size_t, 1>{});
+    check (std::integral_constant<std::size_t, 2>{});
+    check (std::integral_constant<std::size_t, 3>{});
+    check (std::integral_constant<std::size_t, 4>{});
+    check (std::integral_constant<std::size_t, 6>{});
+    check (std::integral_constant<std::size_t, 8>{});
+
+    constexpr Fixed_Matrix<int, 3, 3> singular = {{1, 2, 3},
+                                                  {2, 4, 6},
+                                                  {0, 1, 5}};
+    static_assert (singular.determinant() == 0);
+}
+
+TEST (Fixed_Matrix, Product)
+{
+    auto first = test_matrix<int, 8> (1);
+    auto second = test_matrix<int, 8> (2);
+
+    auto expected = product (first.to_matrix(), second.to_matrix());
+    EXPECT_TRUE (product (first, second).to_matrix() == expected);
+    EXPECT_TRUE (product (first.view(), second.view()) == expected);
+}
+
+TEST (Fixed_Matrix, Conversions)
+{
+    yLab::Matrix<double> matrix = {{1.0, 2.0, 3.0},
+                                   {4.0, 5.0, 6.0}};
+
+    Fixed_Matrix<double, 2, 3> fixed {matrix};
+    EXPECT_TRUE (fixed.to_matrix() == matrix);
+    EXPECT_TRUE (fixed.view() == matrix);
+
+    Fixed_Matrix<double, 3, 2> transposed {matrix.transposed()};
+    EXPECT_TRUE (transposed == fixed.transposed());
+
+    Fixed_Matrix<double, 2, 2> block {matrix.block (0, 1, 2, 2)};
+    EXPECT_EQ (block.determinant(), 2.0 * 6.0 - 3.0 * 5.0);
+
+    EXPECT_THROW ((Fixed_Matrix<double, 3, 3> {matrix}), yLab::Bad_Fixed_Size);
+
+    auto aligned = fixed.to_matrix (yLab::Aligned_Allocator<double>{});
+    EXPECT_TRUE (aligned == matrix);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "lu.hpp"
+
+TEST (LU, Determinant)
+{
+    yLab::Matrix<double> m = {{0, 2, 1},
+                              {3, 1, 4},
+                              {1, 5, 9}};
+
+    EXPECT_NEAR (m.determinant(), -32.0, 1e-12);
+    EXPECT_NEAR (m.lu().determinant(), -32.0, 1e-12);
+
+    yLab::Matrix<double> singular = {{1, 2, 3},
+                                     {2, 4, 6},
+                                     {1, 0, 1}};
+
+    EXPECT_EQ (singular.determinant(), 0.0);
+    EXPECT_EQ (singular.lu().determinant(), 0.0);
+    EXPECT_TRUE (singular.lu().is_singular());
+}
+
+TEST (LU, Solve)
+{
+    yLab::Matrix<double> m = {{2,  1, -1},
+                              {-3, -1, 2},
+                              {-2, 1,  2}};
+    auto lu = m.lu();
+
+    auto x = lu.solve (std::vector<double>{8, -11, -3});
+    ASSERT_EQ (x.size(), 3);
+    EXPECT_NEAR (x[0],  2.0, 1e-12);
+    EXPECT_NEAR (x[1],  3.0, 1e-12);
+    EXPECT_NEAR (x[2], -1.0, 1e-12);
+
+    yLab::Matrix<double> rhs = {{8,  1},
+                                {-11, 0},
+                                {-3, 2}};
+    auto solution = lu.solve (rhs);
+    auto residual = product (m, solution);
+    for (std::size_t i = 0; i != 3; ++i)
+        for (std::size_t j = 0; j != 2; ++j)
+            EXPECT_NEAR (residual[i][j], rhs[i][j], 1e-12);
+
+    EXPECT_THROW (lu.solve (std::vector<double>{1, 2}), yLab::Undef_Solve);
+}
+
+TEST (LU, Inverse)
+{
+    yLab::Matrix<double> m = {{4, 7},
+                              {2, 6}};
+    auto inverse = m.lu().inverse();
+
+    EXPECT_NEAR (inverse[0][0],  0.6, 1e-12);
+    EXPECT_NEAR (inverse[0][1], -0.7, 1e-12);
+    EXPECT_NEAR (inverse[1][0], -0.2, 1e-12);
+    EXPECT_NEAR (inverse[1][1],  0.4, 1e-12);
+
+    yLab::Matrix<double> singular = {{1, 2},
+                                     {2, 4}};
+    EXPECT_THROW (singular.lu().inverse(), yLab::Singular_Matrix);
+
+    yLab::Matrix<double> non_square {2, 3};
+    EXPECT_THROW (non_square.lu(), yLab::Undef_LU);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "matrix.hpp"
+#include "matrix_file.hpp"
+
+namespace
+{
+
+std::string temp_file (const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+template<typename E>
+void write_file (const std::string &path, const E &expr)
+{
+    std::ofstream file {path, std::ios::binary};
+    yLab::write_binary (file, expr);
+}
+
+// Whether the file is mapped into the memory of the process
+bool is_mapped (const std::string &path)
+{
+    std::ifstream maps {"/proc/self/maps"};
+    for (std::string line; std::getline (maps, line);)
+        if (line.find (path) != std::string::npos)
+            return true;
+    return false;
+}
+
+} // unnamed namespace
+
+TEST (Matrix_File, Round_Trip)
+{
+    const auto path = temp_file ("ylab_round_trip.mx");
+
+    yLab::Matrix<double> m = {{1.5, 2.0, -3.0},
+                              {4.0, 5.0,  6.0}};
+    write_file (path, m);
+
+    {
+        yLab::Matrix_File file {path};
+        EXPECT_EQ (file.elem_type(), yLab::Elem_Type::f64);
+        EXPECT_EQ (file.n_rows(), 2);
+        EXPECT_EQ (file.n_cols(), 3);
+
+        auto view = file.view<double>();
+        EXPECT_TRUE (view == m);
+        EXPECT_THROW (file.view<float>(), yLab::Bad_Matrix_File);
+    }
+
+    // Views are written element by element
+    write_file (path, m.transposed());
+    {
+        yLab::Matrix_File file {path};
+        EXPECT_EQ (file.stride(), 2);
+        EXPECT_TRUE (file.view<double>() == m.transposed());
+    }
+
+    std::remove (path.c_str());
+}
+
+TEST (Matrix_File, Padded_Rows)
+{
+    const auto path = temp_file ("ylab_padded_rows.mx");
+
+    yLab::Aligned_Matrix<long long> m = {{2, 1, 0},
+                                         {1, 3, 1},
+                                         {0, 1, 4}};
+    write_file (path, m);
+
+    yLab::Matrix_File file {path};
+    EXPECT_EQ (file.stride(), m.stride());
+
+    auto view = file.view<long long>();
+    EXPECT_EQ (reinterpret_cast<std::uintptr_t>(view.data()) % 64, 0);
+    EXPECT_EQ (view.determinant(), m.determinant());
+
+    std::remove (path.c_str());
+}
+
+TEST (Matrix_File, Bad_Files)
+{
+    const auto path = temp_file ("ylab_bad_file.mx");
+
+    {
+        std::ofstream file {path};
+        file << "3\n1 2 3\n4 5 6\n7 8 9\n0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n";
+    }
+    EXPECT_THROW (yLab::Matrix_File {path}, yLab::Bad_Matrix_File);
+
+    // The header claims more elements than there are in the file
+    write_file (path, yLab::Matrix<int>{4, 4, 1});
+    std::filesystem::resize_file (path, sizeof (yLab::Matrix_File_Header) + 10 * sizeof (int));
+    EXPECT_THROW (yLab::Matrix_File {path}, yLab::Bad_Matrix_File);
+
+    // Rejected files aren't left mapped
+    EXPECT_FALSE (is_mapped (path));
+
+    std::remove (path.c_str());
+
+    EXPECT_THROW (yLab::Matrix_File {path}, yLab::Bad_Matrix_File);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "matrix.hpp"
+#include "matrix_reader.hpp"
+
+TEST (Matrix_Reader, Read_Matrix)
+{
+    std::istringstream is {"3\n 1 -2  +3\n4.5 5e1 6\n\t7 8 9.25\n"};
+    auto m = yLab::read_matrix<double> (is);
+
+    EXPECT_TRUE (m == (yLab::Matrix<double>{{1, -2,    3},
+                                            {4.5, 50,  6},
+                                            {7,  8, 9.25}}));
+
+    std::istringstream aligned_is {"2 1 2 3 4"};
+    auto aligned = yLab::read_matrix<long long> (aligned_is, yLab::Aligned_Allocator<long long>{});
+    EXPECT_EQ (aligned.determinant(), -2);
+}
+
+// Tiny chunks split numbers between reads and make the buffer grow
+TEST (Matrix_Reader, Chunk_Boundaries)
+{
+    std::string text {"4\n"};
+    yLab::Matrix<long long> expected {4, 4};
+    for (auto i = 0; i != 4; ++i)
+        for (auto j = 0; j != 4; ++j)
+        {
+            expected[i][j] = (i - 2) * 1234567891011LL + j;
+            text += std::to_string (expected[i][j]) + ((j == 3) ? "\n" : "   ");
+        }
+
+    for (std::size_t chunk_size : {1, 2, 3, 7, 64})
+    {
+        std::istringstream is {text + text};
+        yLab::Matrix_Reader reader {is, chunk_size};
+
+        EXPECT_TRUE (reader.read<long long>() == expected);
+        EXPECT_TRUE (reader.read<long long>() == expected);
+
+        long long extra;
+        EXPECT_FALSE (reader.next (extra));
+    }
+}
+
+TEST (Matrix_Reader, Bad_Input)
+{
+    std::istringstream empty {"  \n"};
+    EXPECT_THROW (yLab::read_matrix<int> (empty), yLab::Bad_Matrix_Input);
+
+    std::istringstream short_input {"2 1 2 3"};
+    EXPECT_THROW (yLab::read_matrix<int> (short_input), yLab::Bad_Matrix_Input);
+
+    std::istringstream not_a_number {"2 1 2 x 4"};
+    EXPECT_THROW (yLab::read_matrix<int> (not_a_number), yLab::Bad_Matrix_Input);
+
+    std::istringstream fraction {"2 1 2 3.5 4"};
+    EXPECT_THROW (yLab::read_matrix<int> (fraction), yLab::Bad_Matrix_Input);
+
+    std::istringstream overflow {"1 99999999999"};
+    EXPECT_THROW (yLab::read_matrix<int> (overflow), yLab::Bad_Matrix_Input);
+}
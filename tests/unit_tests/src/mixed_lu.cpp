@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "lu.hpp"
+#include "mixed_lu.hpp"
+
+namespace
+{
+
+yLab::Matrix<double> well_conditioned (std::size_t n)
+{
+    return test::well_conditioned (n, static_cast<double>(n) / 4);
+}
+
+std::vector<double> rhs (std::size_t n)
+{
+    std::vector<double> b (n);
+    for (std::size_t i = 0; i != n; ++i)
+        b[i] = std::cos (static_cast<double>(i));
+    return b;
+}
+
+// max |A * x - b| / (||A|| * ||x||)
+double backward_error (const yLab::Matrix<double> &a, const std::vector<double> &x,
+                       const std::vector<double> &b)
+{
+    double residual = 0.0, a_norm = 0.0, x_norm = 0.0;
+    for (std::size_t i = 0; i != a.n_rows(); ++i)
+    {
+        double sum = -b[i], row_norm = 0.0;
+        for (std::size_t j = 0; j != a.n_cols(); ++j)
+        {
+            sum += a[i][j] * x[j];
+            row_norm += std::abs (a[i][j]);
+        }
+        residual = std::max (residual, std::abs (sum));
+        a_norm = std::max (a_norm, row_norm);
+        x_norm = std::max (x_norm, std::abs (x[i]));
+    }
+    return residual / (a_norm * x_norm);
+}
+
+} // unnamed namespace
+
+TEST (Mixed_LU, Solve)
+{
+    for (std::size_t n : {1, 10, 200})
+    {
+        const auto a = well_conditioned (n);
+        const auto b = rhs (n);
+
+        const auto [x, n_steps, fell_back] = a.mixed_lu().solve (b);
+        EXPECT_FALSE (fell_back);
+        EXPECT_LE (n_steps, 5);
+        EXPECT_LT (backward_error (a, x, b), 1e-15);
+
+        const auto x_lu = a.lu().solve (b);
+        for (std::size_t i = 0; i != n; ++i)
+            EXPECT_NEAR (x[i], x_lu[i], 1e-13);
+    }
+
+    EXPECT_THROW (well_conditioned (3).mixed_lu().solve (std::vector<double>(2)), yLab::Undef_Solve);
+    EXPECT_THROW ((yLab::Matrix<double> {2, 3}.mixed_lu()), yLab::Undef_LU);
+}
+
+// Tiled LU decomposes matrices of at least 512 rows
+TEST (Mixed_LU, Tiled)
+{
+    constexpr std::size_t n = 600;
+    const auto a = well_conditioned (n);
+    const auto b = rhs (n);
+
+    const auto result = a.mixed_lu().solve (b);
+    EXPECT_FALSE (result.fell_back);
+    EXPECT_GE (result.n_steps, 1);
+    EXPECT_LT (backward_error (a, result.solution, b), 1e-15);
+}
+
+// Hilbert matrix of order 10 has the condition number of about 1.6e13: float factors
+// don't approximate it, so refinement stalls and the system is solved in double
+TEST (Mixed_LU, Fall_Back)
+{
+    constexpr std::size_t n = 10;
+    yLab::Matrix<double> hilbert {n, n};
+    for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+            hilbert[i][j] = 1.0 / static_cast<double>(i + j + 1);
+
+    const auto b = rhs (n);
+    const auto result = hilbert.mixed_lu().solve (b);
+    EXPECT_TRUE (result.fell_back);
+
+    const auto x_lu = hilbert.lu().solve (b);
+    for (std::size_t i = 0; i != n; ++i)
+        EXPECT_EQ (result.solution[i], x_lu[i]);
+
+    // Elements beyond the range of float
+    yLab::Matrix<double> huge = {{1e300, 1.0},
+                                 {1.0,   2.0}};
+    const auto mixed = huge.mixed_lu();
+    EXPECT_TRUE (mixed.is_singular());
+    EXPECT_TRUE (mixed.solve (std::vector<double>{1.0, 1.0}).fell_back);
+    EXPECT_NEAR (mixed.determinant(), 2e300, 1e288);
+}
+
+TEST (Mixed_LU, Determinant)
+{
+    yLab::Matrix<double> m = {{0, 2, 1},
+                              {3, 1, 4},
+                              {1, 5, 9}};
+    EXPECT_NEAR (m.mixed_lu().determinant(), -32.0, 1e-5);
+
+    // Float overflows at about 3.4e38, but the product is accumulated in double
+    const auto a = well_conditioned (100);
+    const auto expected = a.lu().determinant();
+    ASSERT_GT (std::abs (expected), 1e40);
+    EXPECT_NEAR (a.mixed_lu().determinant(), expected, 1e-4 * std::abs (expected));
+
+    yLab::Matrix<double> singular = {{1, 2},
+                                     {2, 4}};
+    EXPECT_EQ (singular.mixed_lu().determinant(), 0.0);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+
+#include "modular_det.hpp"
+
+TEST (Modular_Det, Montgomery)
+{
+    const std::uint32_t p = 2147483647;
+    const yLab::detail::Montgomery mont {p};
+
+    const std::uint32_t a = 123456789, b = 987654321;
+    const auto product = mont.from_montgomery (mont.mul (mont.to_montgomery (a), mont.to_montgomery (b)));
+    EXPECT_EQ (product, static_cast<std::uint64_t>(a) * b % p);
+
+    const auto a_inv = mont.inverse (mont.to_montgomery (a));
+    EXPECT_EQ (mont.from_montgomery (mont.mul (a_inv, mont.to_montgomery (a))), 1);
+}
+
+TEST (Modular_Det, Primes)
+{
+    auto primes = yLab::detail::modular_primes (3);
+    ASSERT_EQ (primes.size(), 3);
+    EXPECT_EQ (primes[0], 2147483647u);
+    EXPECT_EQ (primes[1], 2147483629u);
+    EXPECT_EQ (primes[2], 2147483587u);
+}
+
+TEST (Modular_Det, Determinant)
+{
+    yLab::Matrix<long long> m = {{ 2, -3,  1},
+                                 { 2,  0, -1},
+                                 { 1,  4,  5}};
+    EXPECT_EQ (yLab::modular_determinant (m), 49);
+    EXPECT_EQ (yLab::modular_determinant (yLab::execution::seq, m), 49);
+
+    yLab::Matrix<long long> singular = {{1, 2, 3},
+                                        {4, 5, 6},
+                                        {7, 8, 9}};
+    EXPECT_EQ (yLab::modular_determinant (singular), 0);
+
+    yLab::Matrix<int> zero_row = {{1, 2},
+                                  {0, 0}};
+    EXPECT_EQ (yLab::modular_determinant (zero_row), 0);
+}
+
+TEST (Modular_Det, Large_Entries)
+{
+    // Bareiss algorithm overflows long long on intermediate values of this matrix
+    constexpr long long big = 3'000'000'000;
+    yLab::Matrix<long long> m = {{big,     1,   0},
+                                 {  1,   big,   1},
+                                 {  0,     1, big}};
+    EXPECT_THROW (yLab::modular_determinant (m), yLab::Det_Overflow);
+
+    yLab::Matrix<long long> fits = {{big, 1},
+                                    {  1, 2}};
+    EXPECT_EQ (yLab::modular_determinant (fits), 2 * big - 1);
+
+    yLab::Matrix<long long> negative = {{ 1, big},
+                                        {big,  1}};
+    EXPECT_EQ (yLab::modular_determinant (negative), 1 - big * big);
+}
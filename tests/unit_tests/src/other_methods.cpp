@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <cstddef>
+#include <utility>
 
 #include "matrix.hpp"
 
@@ -66,3 +68,32 @@ TEST (Other_Methods, Transposition)
     auto m_3_copy = m_3;
     EXPECT_TRUE (m_3 == m_3_copy.transpose().transpose());
 }
+
+TEST (Other_Methods, Large_Transposition)
+{
+    for (auto [n_rows, n_cols] : {std::pair{100, 100}, std::pair{37, 101}, std::pair{130, 3},
+                                  std::pair{1, 50}})
+    {
+        yLab::Matrix<int> m {static_cast<std::size_t>(n_rows), static_cast<std::size_t>(n_cols)};
+        for (int i = 0; i != n_rows; ++i)
+            for (int j = 0; j != n_cols; ++j)
+                m[i][j] = i * 1000 + j;
+
+        yLab::Matrix<int> m_T {m.n_cols(), m.n_rows()};
+        for (int i = 0; i != n_rows; ++i)
+            for (int j = 0; j != n_cols; ++j)
+                m_T[j][i] = m[i][j];
+
+        auto copy = m;
+        EXPECT_TRUE (copy.transpose() == m_T);
+
+        copy = m;
+        EXPECT_TRUE (copy.transpose_in_place() == m_T);
+        EXPECT_EQ (copy.n_rows(), m.n_cols());
+
+        yLab::Aligned_Matrix<int> aligned {m.n_rows(), m.n_cols()};
+        aligned = m;
+        EXPECT_TRUE (aligned.transpose_in_place() == m_T);
+        EXPECT_TRUE (aligned.transpose() == m);
+    }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <random>
+
+#include "matrix.hpp"
+#include "modular_det.hpp"
+#include "random_matrix.hpp"
+
+TEST (Random_Matrix, Determinant)
+{
+    for (std::size_t size : {1, 2, 5, 12})
+        for (int det : {-7, 0, 1, 42})
+        {
+            std::mt19937_64 gen {yLab::random_matrix_seed (2024, size)};
+            auto matrix = yLab::random_matrix<long long> (size, det, gen);
+
+            EXPECT_EQ (matrix.n_rows(), size);
+            EXPECT_EQ (matrix.determinant(), det);
+        }
+}
+
+TEST (Random_Matrix, Reproducibility)
+{
+    std::mt19937_64 gen_1 {yLab::random_matrix_seed (1, 3)};
+    std::mt19937_64 gen_2 {yLab::random_matrix_seed (1, 3)};
+    std::mt19937_64 gen_3 {yLab::random_matrix_seed (1, 4)};
+
+    auto m_1 = yLab::random_matrix<long long> (16, 5, gen_1);
+    auto m_2 = yLab::random_matrix<long long> (16, 5, gen_2);
+    auto m_3 = yLab::random_matrix<long long> (16, 5, gen_3);
+
+    EXPECT_TRUE (m_1 == m_2);
+    EXPECT_FALSE (m_1 == m_3);
+
+    // The same elements whatever the type and the layout of the storage
+    std::mt19937_64 gen_4 {yLab::random_matrix_seed (1, 3)};
+    auto aligned = yLab::random_matrix<double> (16, 5, gen_4, yLab::Aligned_Allocator<double>{});
+    for (std::size_t i = 0; i != 16; ++i)
+        for (std::size_t j = 0; j != 16; ++j)
+            EXPECT_EQ (aligned[i][j], static_cast<double>(m_1[i][j]));
+}
+
+TEST (Random_Matrix, Large)
+{
+    constexpr std::size_t size = 2000;
+    constexpr long long det = -42;
+
+    std::mt19937_64 gen {yLab::random_matrix_seed (2024, size)};
+    auto matrix = yLab::random_matrix<long long> (size, det, gen);
+
+    // Elements don't grow with the size
+    constexpr auto bound = (yLab::detail::random_matrix_row_terms + 1) * std::llabs (det);
+    for (std::size_t i = 0; i != size; ++i)
+        for (std::size_t j = 0; j != size; ++j)
+            ASSERT_LE (std::llabs (matrix[i][j]), bound);
+
+    const auto p = yLab::detail::modular_primes (1).front();
+    EXPECT_EQ (yLab::detail::det_mod_prime (matrix, p), det % p + p);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simd.hpp"
+
+namespace
+{
+
+using yLab::detail::simd::Isa;
+
+template<typename T>
+std::vector<T> make_row (std::size_t n, int seed)
+{
+    std::vector<T> row (n);
+    for (std::size_t j = 0; j != n; ++j)
+        row[j] = static_cast<T>((static_cast<int>(j) * 7 + seed) % 13 - 6);
+    return row;
+}
+
+// Every kernel must give the same results as plain loops for every supported ISA
+// and for every length, so that the tails are covered as well
+template<typename T>
+void check_kernels (Isa isa)
+{
+    namespace simd = yLab::detail::simd;
+
+    for (std::size_t n = 0; n != 70; ++n)
+    {
+        const auto x = make_row<T>(n, 3);
+        auto y = make_row<T>(n, 5);
+        auto expected = y;
+
+        simd::sub_scaled (n, y.data(), x.data(), T{3}, isa);
+        for (std::size_t j = 0; j != n; ++j)
+            expected[j] -= T{3} * x[j];
+        ASSERT_EQ (y, expected);
+
+        simd::bareiss_update (n, y.data(), x.data(), T{4}, T{2}, T{2}, isa);
+        for (std::size_t j = 0; j != n; ++j)
+            expected[j] = (expected[j] * T{4} - x[j] * T{2}) / T{2};
+        ASSERT_EQ (y, expected);
+
+        simd::add (n, y.data(), x.data(), isa);
+        simd::subtract (n, y.data(), x.data(), isa);
+        simd::subtract (n, y.data(), x.data(), isa);
+        for (std::size_t j = 0; j != n; ++j)
+            expected[j] -= x[j];
+        ASSERT_EQ (y, expected);
+
+        simd::multiply (n, y.data(), T{6}, isa);
+        simd::divide (n, y.data(), T{3}, isa);
+        for (std::size_t j = 0; j != n; ++j)
+            expected[j] = expected[j] * T{6} / T{3};
+        ASSERT_EQ (y, expected);
+    }
+}
+
+// alpha * x[j] isn't exact, so a fused multiply-add would round it differently
+template<typename T>
+std::vector<T> sub_scaled_result (Isa isa)
+{
+    constexpr std::size_t n = 70;
+    std::vector<T> x (n), y (n);
+    for (std::size_t j = 0; j != n; ++j)
+    {
+        x[j] = static_cast<T>(std::sin (static_cast<double>(j) + 1));
+        y[j] = static_cast<T>(std::cos (static_cast<double>(j) + 1));
+    }
+
+    yLab::detail::simd::sub_scaled (n, y.data(), x.data(), T{0.1}, isa);
+    return y;
+}
+
+} // unnamed namespace
+
+TEST (SIMD, Kernels)
+{
+    for (auto isa : {Isa::sse2, Isa::avx2, Isa::avx512})
+    {
+        if (!yLab::detail::simd::is_supported (isa))
+            continue;
+
+        check_kernels<float>(isa);
+        check_kernels<double>(isa);
+        check_kernels<std::int32_t>(isa);
+        check_kernels<std::int64_t>(isa);
+    }
+}
+
+// Results mustn't depend on the CPU: products aren't contracted into FMA by wider kernels
+TEST (SIMD, Same_Results_For_All_ISAs)
+{
+    for (auto isa : {Isa::avx2, Isa::avx512})
+    {
+        if (!yLab::detail::simd::is_supported (isa))
+            continue;
+
+        EXPECT_EQ (sub_scaled_result<float>(isa), sub_scaled_result<float>(Isa::sse2));
+        EXPECT_EQ (sub_scaled_result<double>(isa), sub_scaled_result<double>(Isa::sse2));
+    }
+}
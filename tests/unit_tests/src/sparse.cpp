@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "matrix.hpp"
+#include "sparse_lu.hpp"
+#include "sparse_matrix.hpp"
+#include "thread_pool.hpp"
+
+using yLab::CSC_Matrix;
+using yLab::CSR_Matrix;
+using yLab::Triplet;
+
+namespace
+{
+
+// 5-point Laplacian of a grid x grid mesh plus shift on the diagonal
+template<typename T>
+std::vector<Triplet<T>> laplacian (std::size_t grid, T shift = T{})
+{
+    std::vector<Triplet<T>> entries;
+    for (std::size_t i = 0; i != grid; ++i)
+        for (std::size_t j = 0; j != grid; ++j)
+        {
+            const auto v = i * grid + j;
+            entries.push_back ({v, v, T{4} + shift});
+            if (i != 0)        entries.push_back ({v, v - grid, T{-1}});
+            if (i + 1 != grid) entries.push_back ({v, v + grid, T{-1}});
+            if (j != 0)        entries.push_back ({v, v - 1, T{-1}});
+            if (j + 1 != grid) entries.push_back ({v, v + 1, T{-1}});
+        }
+    return entries;
+}
+
+// Random matrix with about density * n * n nonzeros and a nonzero diagonal
+std::vector<Triplet<double>> random_entries (std::size_t n, double density, std::uint64_t seed)
+{
+    std::mt19937_64 gen {seed};
+    std::uniform_real_distribution<double> value {-1.0, 1.0};
+    std::uniform_int_distribution<std::size_t> index {0, n - 1};
+
+    std::vector<Triplet<double>> entries;
+    for (std::size_t i = 0; i != n; ++i)
+        entries.push_back ({i, i, 0.5 + value (gen)});
+    for (std::size_t k = 0; k != static_cast<std::size_t>(density * n * n); ++k)
+        entries.push_back ({index (gen), index (gen), value (gen)});
+    return entries;
+}
+
+} // unnamed namespace
+
+TEST (Sparse, Construction)
+{
+    CSR_Matrix<int> csr {3, 4, {{2, 1, 5}, {0, 3, 1}, {0, 0, 2}, {2, 1, 1}, {1, 2, 3}, {1, 2, -3}}};
+
+    EXPECT_EQ (csr.nnz(), 3);
+    EXPECT_EQ (csr (2, 1), 6);
+    EXPECT_EQ (csr (0, 3), 1);
+    EXPECT_EQ (csr (1, 2), 0);
+    EXPECT_THROW (csr (3, 0), yLab::Bad_Sparse_Entry);
+
+    yLab::Matrix<int> dense = {{2, 0, 0, 1},
+                               {0, 0, 0, 0},
+                               {0, 6, 0, 0}};
+    EXPECT_TRUE (csr.to_matrix() == dense);
+    EXPECT_TRUE (CSR_Matrix<int> {dense} == csr);
+
+    CSC_Matrix<int> csc {csr};
+    EXPECT_TRUE (csc.to_matrix() == dense);
+    EXPECT_TRUE (CSR_Matrix<int> {csc} == csr);
+    EXPECT_TRUE (CSC_Matrix<int> {dense} == csc);
+    EXPECT_TRUE (csr.transposed().to_matrix() == yLab::Matrix<int> (dense.transposed()));
+
+    EXPECT_THROW ((CSR_Matrix<int> {2, 2, {{2, 0, 1}}}), yLab::Bad_Sparse_Entry);
+}
+
+TEST (Sparse, Compressed_Arrays)
+{
+    CSR_Matrix<double> matrix {2, 3, {0, 2, 3}, {0, 2, 1}, {1.0, 2.0, 3.0}};
+    EXPECT_EQ (matrix (0, 2), 2.0);
+    EXPECT_EQ (matrix (1, 1), 3.0);
+
+    EXPECT_THROW ((CSR_Matrix<double> {2, 3, {0, 2, 3}, {2, 0, 1}, {1.0, 2.0, 3.0}}),
+                  yLab::Bad_Sparse_Structure);
+    EXPECT_THROW ((CSR_Matrix<double> {2, 3, {0, 2}, {0, 2}, {1.0, 2.0}}), yLab::Bad_Sparse_Structure);
+    EXPECT_THROW ((CSR_Matrix<double> {2, 3, {0, 1, 1}, {0}, {0.0}}), yLab::Bad_Sparse_Structure);
+}
+
+TEST (Sparse, Matrix_Vector_Product)
+{
+    const CSR_Matrix<double> csr {100, 100, random_entries (100, 0.05, 1)};
+    const CSC_Matrix<double> csc {csr};
+    const auto dense = csr.to_matrix();
+
+    std::vector<double> x (100);
+    for (std::size_t i = 0; i != x.size(); ++i)
+        x[i] = std::sin (static_cast<double>(i));
+
+    yLab::Matrix<double> x_column {100, 1, x.begin(), x.end()};
+    const auto expected = product (dense, x_column);
+
+    yLab::Thread_Pool pool {4};
+    for (const auto &y : {product (csr, x), product (csc, x),
+                          product (yLab::execution::par.on (pool), csr, x),
+                          product (yLab::execution::seq, csc, x)})
+    {
+        ASSERT_EQ (y.size(), 100);
+        for (std::size_t i = 0; i != y.size(); ++i)
+            EXPECT_NEAR (y[i], expected[i][0], 1e-12);
+    }
+
+    EXPECT_THROW (product (csr, std::vector<double>(99)), yLab::Undef_Product);
+}
+
+TEST (Sparse, Matrix_Matrix_Product)
+{
+    const CSR_Matrix<long long> first {30, 40, {{0, 0, 1}, {3, 7, 2}, {3, 8, -1}, {29, 39, 4}, {12, 5, 3}}};
+    const CSR_Matrix<long long> second {40, 20, {{7, 1, 3}, {8, 1, 6}, {39, 19, 1}, {5, 5, -2}, {0, 0, 5}}};
+
+    const auto expected = product (first.to_matrix(), second.to_matrix());
+
+    const auto csr = product (first, second);
+    EXPECT_TRUE (csr.to_matrix() == expected);
+    EXPECT_EQ (csr (3, 1), 0); // 2 * 3 - 1 * 6 cancels out
+    EXPECT_EQ (csr.nnz(), 3);
+
+    const auto csc = product (CSC_Matrix<long long> {first}, CSC_Matrix<long long> {second});
+    static_assert (decltype (csc)::layout == yLab::Sparse_Layout::csc);
+    EXPECT_TRUE (csc.to_matrix() == expected);
+    EXPECT_TRUE (product (CSC_Matrix<long long> {first}, second) == csr);
+
+    EXPECT_THROW (product (first, first), yLab::Undef_Product);
+}
+
+TEST (Sparse, Determinant)
+{
+    yLab::Matrix<double> m = {{0, 2, 1},
+                              {3, 1, 4},
+                              {1, 5, 9}};
+    EXPECT_NEAR (CSR_Matrix<double> {m}.determinant(), -32.0, 1e-12);
+    EXPECT_NEAR (CSC_Matrix<double> {m}.determinant(), -32.0, 1e-12);
+
+    yLab::Matrix<double> singular = {{1, 2, 3},
+                                     {2, 4, 6},
+                                     {1, 0, 1}};
+    EXPECT_EQ (CSR_Matrix<double> {singular}.determinant(), 0.0);
+    EXPECT_TRUE (CSR_Matrix<double> {singular}.lu().is_singular());
+    EXPECT_EQ ((CSR_Matrix<double> {3, 3, {{0, 0, 1.0}, {1, 1, 1.0}}}.determinant()), 0.0);
+
+    for (std::uint64_t seed = 0; seed != 5; ++seed)
+    {
+        const CSR_Matrix<double> sparse {60, 60, random_entries (60, 0.04, seed)};
+        const auto expected = sparse.to_matrix().determinant();
+        EXPECT_NEAR (sparse.determinant(), expected, 1e-9 * std::abs (expected));
+    }
+
+    EXPECT_THROW ((CSR_Matrix<double> {2, 3}.determinant()), yLab::Undef_Det);
+}
+
+// The ordering keeps the factors of a grid Laplacian far from dense
+TEST (Sparse, Fill_In)
+{
+    constexpr std::size_t grid = 30, n = grid * grid;
+    const CSC_Matrix<double> matrix {n, n, laplacian<double> (grid, 0.01)};
+
+    const auto lu = matrix.lu();
+    EXPECT_FALSE (lu.is_singular());
+    EXPECT_LT (lu.nnz(), 30 * matrix.nnz());
+
+    std::vector<double> b (n, 1.0);
+    const auto x = lu.solve (b);
+    const auto residual = product (matrix, x);
+    for (std::size_t i = 0; i != n; ++i)
+        EXPECT_NEAR (residual[i], 1.0, 1e-10);
+
+    // log |det| is compared, as the determinant itself is huge
+    const auto small = CSR_Matrix<double> {64, 64, laplacian<double> (8)};
+    EXPECT_NEAR (std::log (small.determinant()), std::log (small.to_matrix().determinant()), 1e-10);
+}
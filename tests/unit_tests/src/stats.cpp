@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "matrix.hpp"
+#include "stats.hpp"
+
+using yLab::stats::Op;
+using yLab::stats::Phase;
+
+TEST (Stats, Disabled)
+{
+    if constexpr (yLab::stats::enabled)
+        GTEST_SKIP() << "Instrumentation is enabled";
+
+    yLab::Matrix<double> m = {{1, 2}, {3, 4}};
+    EXPECT_DOUBLE_EQ (m.determinant(), -2);
+
+    const auto stats = yLab::stats::snapshot();
+    EXPECT_EQ (stats[Op::determinant].calls, 0);
+    EXPECT_EQ (stats[Phase::elimination].count(), 0);
+}
+
+TEST (Stats, Determinant_And_Copies)
+{
+    if constexpr (!yLab::stats::enabled)
+        GTEST_SKIP() << "Instrumentation is compiled out: configure with -DYLAB_STATS=ON";
+
+    yLab::Matrix<double> m = {{0, 1, 2},
+                              {3, 4, 5},
+                              {6, 7, 9}};
+    yLab::Matrix<long long> i_m = {{0, 1, 2},
+                                   {1, 0, 3},
+                                   {4, 5, 6}};
+
+    const auto before = yLab::stats::snapshot();
+    m.determinant();
+    i_m.determinant();
+    const auto stats = yLab::stats::snapshot() - before;
+
+    const auto &det = stats[Op::determinant];
+    EXPECT_EQ (det.calls, 2);
+    EXPECT_EQ (det.flops, 2 * 27 / 3 + 4 * 27 / 3);
+    EXPECT_GE (det.pivot_swaps, 2);
+    EXPECT_EQ (det.allocations, 1); // permutation of Gaussian elimination
+
+    // Both determinants work on copies
+    const auto &copy = stats[Op::copy];
+    EXPECT_EQ (copy.calls, 2);
+    EXPECT_EQ (copy.allocations, 2);
+    EXPECT_EQ (copy.bytes, 2 * (9 * sizeof (double) + 9 * sizeof (long long)));
+
+    EXPECT_GT (stats[Phase::elimination].count(), 0);
+    EXPECT_GT (stats[Phase::pivot_search].count(), 0);
+
+    std::ostringstream os;
+    os << stats;
+    EXPECT_NE (os.str().find ("determinant: 2 calls"), std::string::npos);
+}
+
+TEST (Stats, Product_And_Transpose)
+{
+    if constexpr (!yLab::stats::enabled)
+        GTEST_SKIP() << "Instrumentation is compiled out: configure with -DYLAB_STATS=ON";
+
+    yLab::Matrix<int> a {2, 3, 1};
+    yLab::Matrix<int> b {3, 4, 1};
+
+    const auto before = yLab::stats::snapshot();
+    auto c = yLab::product (a, b);
+    auto d = yLab::product (a.transposed(), a);
+    c.transpose();
+    const auto stats = yLab::stats::snapshot() - before;
+
+    EXPECT_EQ (stats[Op::product].calls, 2);
+    EXPECT_EQ (stats[Op::product].flops, 2 * 2 * 4 * 3 + 2 * 3 * 3 * 2);
+    EXPECT_EQ (stats[Op::product].allocations, 2);
+    EXPECT_EQ (stats[Op::transpose].calls, 1);
+    EXPECT_EQ (stats[Op::transpose].bytes, 2 * 8 * sizeof (int));
+    EXPECT_EQ (d.n_rows(), 3);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+
+#include "common.hpp"
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+
+// Small cutoffs make odd sizes peel on several levels of the recursion
+TEST (Strassen, Integral_Product)
+{
+    for (std::size_t size : {1, 2, 7, 16, 33, 64, 101, 150})
+        for (std::size_t cutoff : {1, 4, 16})
+        {
+            auto first = test::random_matrix<long long> (size, size, 1);
+            auto second = test::random_matrix<long long> (size, size, 2);
+
+            auto expected = product (first, second, yLab::algorithm::classical);
+            EXPECT_TRUE (product (first, second, yLab::algorithm::Strassen {cutoff}) == expected);
+        }
+}
+
+TEST (Strassen, Floating_Point_Product)
+{
+    for (std::size_t size : {31, 64, 129})
+    {
+        auto first = test::random_matrix<double> (size, size, 3);
+        auto second = test::random_matrix<double> (size, size, 4);
+
+        // Elements are small integers, so the results are exact
+        auto expected = product (first, second, yLab::algorithm::classical);
+        EXPECT_TRUE (product (first, second, yLab::algorithm::Strassen {8}) == expected);
+    }
+}
+
+TEST (Strassen, Padded_Rows)
+{
+    using Matrix = yLab::Matrix<int, yLab::Aligned_Allocator<int>>;
+
+    Matrix first {45, 45};
+    Matrix second {45, 45};
+    for (std::size_t i = 0; auto &elem : first)
+        elem = static_cast<int>(i++ % 17) - 8;
+    for (std::size_t i = 0; auto &elem : second)
+        elem = static_cast<int>(i++ % 13) - 6;
+
+    auto expected = product (first, second, yLab::algorithm::classical);
+    EXPECT_TRUE (product (first, second, yLab::algorithm::Strassen {5}) == expected);
+}
+
+TEST (Strassen, Parallel_Product)
+{
+    yLab::Thread_Pool pool {4};
+
+    auto first = test::random_matrix<int> (97, 97, 5);
+    auto second = test::random_matrix<int> (97, 97, 6);
+
+    auto expected = product (first, second, yLab::algorithm::classical);
+    EXPECT_TRUE (product (yLab::execution::par.on (pool), first, second,
+                          yLab::algorithm::Strassen {12}) == expected);
+    EXPECT_TRUE (product (yLab::execution::seq, first, second, yLab::algorithm::strassen) == expected);
+}
+
+// Strassen-Winograd algorithm applies to square products only
+TEST (Strassen, Rectangular_Product)
+{
+    yLab::Matrix<int> first = {{1, 2},
+                               {3, 4},
+                               {5, 6}};
+    yLab::Matrix<int> second = {{1, 0, 1},
+                                {0, 1, 1}};
+    yLab::Matrix<int> expected = {{1, 2, 3},
+                                  {3, 4, 7},
+                                  {5, 6, 11}};
+
+    EXPECT_TRUE (product (first, second, yLab::algorithm::Strassen {1}) == expected);
+    EXPECT_THROW (product (first, first, yLab::algorithm::strassen), yLab::Undef_Product);
+}
+
+TEST (Strassen, Automatic_Choice)
+{
+    EXPECT_TRUE (yLab::detail::prefers_strassen<long long> (4096, 4096, 4096));
+    EXPECT_FALSE (yLab::detail::prefers_strassen<long long> (4096, 4096, 4095));
+    EXPECT_FALSE (yLab::detail::prefers_strassen<long long> (16, 16, 16));
+    EXPECT_FALSE (yLab::detail::prefers_strassen<double> (4096, 4096, 4096));
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "matrix.hpp"
+
+namespace structure = yLab::structure;
+
+namespace
+{
+
+// Elements within the band are nonzero, the others are zeros
+template<typename T>
+yLab::Matrix<T> band_matrix (std::size_t n, std::size_t lower, std::size_t upper)
+{
+    yLab::Matrix<T> matrix {n, n};
+    for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+            if (i <= j + lower && j <= i + upper)
+                matrix[i][j] = static_cast<T>((i * 5 + j * 3) % 7) + (i == j ? T{3} : T{1});
+    return matrix;
+}
+
+template<typename T>
+yLab::Structure detect (const yLab::Matrix<T> &matrix)
+{
+    return yLab::detail::detect_structure (matrix.n_rows(), matrix.data(), matrix.stride());
+}
+
+} // unnamed namespace
+
+TEST (Structure, Detection)
+{
+    EXPECT_TRUE (std::holds_alternative<structure::Diagonal> (detect (band_matrix<int> (10, 0, 0))));
+    EXPECT_TRUE (std::holds_alternative<structure::Upper_Triangular> (detect (band_matrix<int> (10, 0, 9))));
+    EXPECT_TRUE (std::holds_alternative<structure::Lower_Triangular> (detect (band_matrix<int> (10, 4, 0))));
+    EXPECT_TRUE (std::holds_alternative<structure::Tridiagonal> (detect (band_matrix<int> (10, 1, 1))));
+    EXPECT_TRUE (std::holds_alternative<structure::General> (detect (band_matrix<int> (10, 9, 9))));
+
+    auto banded = detect (band_matrix<int> (40, 3, 2));
+    ASSERT_TRUE (std::holds_alternative<structure::Banded> (banded));
+    EXPECT_EQ (std::get<structure::Banded> (banded).lower, 3);
+    EXPECT_EQ (std::get<structure::Banded> (banded).upper, 2);
+
+    yLab::Matrix<int> blocks = {{1, 2, 0, 0, 0},
+                                {3, 4, 0, 0, 0},
+                                {0, 0, 5, 6, 7},
+                                {0, 0, 8, 9, 1},
+                                {0, 0, 2, 3, 5}};
+    auto block_diagonal = detect (blocks);
+    ASSERT_TRUE (std::holds_alternative<structure::Block_Diagonal> (block_diagonal));
+    EXPECT_EQ (std::get<structure::Block_Diagonal> (block_diagonal).offsets,
+               (std::vector<std::size_t>{0, 2, 5}));
+}
+
+TEST (Structure, Integral_Determinants)
+{
+    for (auto [lower, upper] : {std::pair<std::size_t, std::size_t>{0, 0}, {0, 5}, {5, 0}, {1, 1},
+                                {2, 1}, {1, 3}, {2, 2}})
+    {
+        // Bareiss algorithm multiplies minors, so the size is kept small enough not to overflow
+        auto matrix = band_matrix<long long> (9, lower, upper);
+        matrix[3][3] = 0; // makes banded elimination pivot
+
+        EXPECT_EQ (matrix.determinant(), matrix.determinant (structure::General{}))
+            << "lower = " << lower << ", upper = " << upper;
+        EXPECT_EQ (matrix.determinant (structure::Banded{lower, upper}),
+                   matrix.determinant (structure::General{}));
+    }
+
+    // Pivots on a row entering the window, which is scaled lazily
+    yLab::Matrix<long long> m = {{2, 1, 0, 0},
+                                 {4, 3, 1, 0},
+                                 {0, 5, 2, 1},
+                                 {0, 0, 7, 4}};
+    EXPECT_EQ (m.determinant (structure::Banded{1, 1}), m.determinant (structure::General{}));
+    EXPECT_EQ (m.determinant (structure::Tridiagonal{}), m.determinant (structure::General{}));
+}
+
+TEST (Structure, Floating_Point_Determinants)
+{
+    for (auto [lower, upper] : {std::pair<std::size_t, std::size_t>{0, 3}, {1, 1}, {2, 3}, {4, 1}})
+    {
+        auto matrix = band_matrix<double> (50, lower, upper);
+        const auto expected = matrix.determinant (structure::General{});
+        EXPECT_NEAR (matrix.determinant(), expected, 1e-9 * std::abs (expected));
+    }
+
+    yLab::Matrix<double> singular = {{1, 2, 0},
+                                     {2, 4, 0},
+                                     {0, 3, 1}};
+    EXPECT_EQ (singular.determinant(), 0.0);
+}
+
+TEST (Structure, Block_Diagonal)
+{
+    yLab::Matrix<long long> blocks = {{1, 2, 0, 0, 0, 0},
+                                      {3, 4, 0, 0, 0, 0},
+                                      {0, 0, 5, 0, 0, 0},
+                                      {0, 0, 0, 2, 6, 7},
+                                      {0, 0, 0, 8, 9, 1},
+                                      {0, 0, 0, 2, 3, 5}};
+
+    EXPECT_EQ (blocks.determinant(), blocks.determinant (structure::General{}));
+    EXPECT_EQ (blocks.determinant (structure::Block_Diagonal{{0, 2, 3, 6}}), -2 * 5 * -102);
+
+    // Offsets that don't split the matrix into blocks
+    EXPECT_THROW (blocks.determinant (structure::Block_Diagonal{}), yLab::Undef_Det);
+    EXPECT_THROW (blocks.determinant (structure::Block_Diagonal{{2, 3, 6}}), yLab::Undef_Det);
+    EXPECT_THROW (blocks.determinant (structure::Block_Diagonal{{0, 2, 3}}), yLab::Undef_Det);
+    EXPECT_THROW (blocks.determinant (structure::Block_Diagonal{{0, 3, 2, 6}}), yLab::Undef_Det);
+    EXPECT_THROW (blocks.determinant (structure::Block_Diagonal{{0, 2, 2, 6}}), yLab::Undef_Det);
+    EXPECT_THROW (blocks.determinant (structure::Block_Diagonal{{0, 2, 3, 9}}), yLab::Undef_Det);
+}
+
+// Hints are trusted: elements outside of the structure aren't read
+TEST (Structure, Hints)
+{
+    yLab::Matrix<int> m = {{2, 7, 7},
+                           {0, 3, 7},
+                           {9, 0, 4}};
+
+    EXPECT_EQ (m.determinant (structure::Upper_Triangular{}), 24);
+    EXPECT_EQ (m.determinant (structure::Diagonal{}), 24);
+    EXPECT_EQ (m.determinant(), m.determinant (structure::General{}));
+
+    yLab::Matrix<int> rectangular {2, 3};
+    EXPECT_THROW (rectangular.determinant (structure::Diagonal{}), yLab::Undef_Det);
+}
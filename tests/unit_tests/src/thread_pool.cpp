@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+TEST (Thread_Pool, Submit)
+{
+    yLab::Thread_Pool pool {3};
+    EXPECT_EQ (pool.n_threads(), 3);
+
+    auto future = pool.submit ([]{ return 42; });
+    EXPECT_EQ (future.get(), 42);
+}
+
+TEST (Thread_Pool, Parallel_For)
+{
+    yLab::Thread_Pool pool {4};
+
+    std::vector<int> visited (1000);
+    pool.parallel_for (visited.size(), [&visited](std::size_t i){ visited[i] += 1; });
+
+    for (auto count : visited)
+        EXPECT_EQ (count, 1);
+}
+
+TEST (Thread_Pool, Nested_Parallel_For)
+{
+    yLab::Thread_Pool pool {2};
+
+    std::atomic<int> count = 0;
+    pool.parallel_for (8, [&](std::size_t)
+    {
+        pool.parallel_for (8, [&](std::size_t){ ++count; });
+    });
+
+    EXPECT_EQ (count, 64);
+}
+
+TEST (Thread_Pool, Exception_Propagation)
+{
+    yLab::Thread_Pool pool {2};
+
+    EXPECT_THROW (pool.parallel_for (16, [](std::size_t i)
+                  {
+                      if (i == 7)
+                          throw std::runtime_error{"task failed"};
+                  }),
+                  std::runtime_error);
+}
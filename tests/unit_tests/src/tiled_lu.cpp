@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.hpp"
+#include "task_graph.hpp"
+#include "tiled_lu.hpp"
+
+TEST (Task_Graph, Dependencies)
+{
+    yLab::Thread_Pool pool {4};
+    yLab::Task_Graph graph;
+
+    std::vector<int> order;
+    std::mutex mutex;
+    auto record = [&](int i){ return [&, i]{ std::lock_guard lock {mutex}; order.push_back (i); }; };
+
+    auto first  = graph.add_task (record (0));
+    auto second = graph.add_task (record (1));
+    auto third  = graph.add_task (record (2));
+    graph.add_dependency (first, second);
+    graph.add_dependency (second, third);
+
+    graph.run (pool);
+    EXPECT_EQ (order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST (Task_Graph, Exception_Propagation)
+{
+    yLab::Thread_Pool pool {2};
+    yLab::Task_Graph graph;
+
+    bool ran = false;
+    auto failing = graph.add_task ([]{ throw std::runtime_error{"task failed"}; });
+    auto skipped = graph.add_task ([&ran]{ ran = true; });
+    graph.add_dependency (failing, skipped);
+
+    EXPECT_THROW (graph.run (pool), std::runtime_error);
+    EXPECT_FALSE (ran);
+}
+
+TEST (Tiled_LU, Decomposition)
+{
+    constexpr std::size_t n = 157;
+    constexpr std::size_t block_size = 16;
+
+    std::mt19937 gen {42};
+    std::uniform_real_distribution<double> dist {-1.0, 1.0};
+
+    yLab::Matrix<double> m {n, n};
+    for (auto &elem : m)
+        elem = dist (gen);
+
+    auto factors = m;
+    std::vector<std::size_t> ipiv (n);
+    yLab::Thread_Pool pool {4};
+    const int sign = yLab::detail::tiled_lu_decompose (pool, n, factors.data(), n, ipiv.data(),
+                                                       block_size);
+    ASSERT_NE (sign, 0);
+
+    // Apply the row interchanges to A and compare with L * U
+    auto permuted = m;
+    for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+            if (ipiv[i] != i)
+                std::swap (permuted[i][j], permuted[ipiv[i]][j]);
+
+    for (std::size_t i = 0; i != n; ++i)
+        for (std::size_t j = 0; j != n; ++j)
+        {
+            double lu = (i <= j) ? factors[i][j] : 0.0;
+            for (std::size_t p = 0; p < std::min (i, j + 1); ++p)
+                lu += factors[i][p] * factors[p][j];
+
+            EXPECT_NEAR (lu, permuted[i][j], 1e-10);
+        }
+}
+
+TEST (Tiled_LU, Determinant)
+{
+    constexpr std::size_t n = 600;
+
+    std::mt19937 gen {7};
+    std::uniform_real_distribution<double> dist {-1.0, 1.0};
+
+    // Diagonally dominant: the determinant is far from both zero and overflow
+    yLab::Matrix<double> m {n, n};
+    for (auto &elem : m)
+        elem = dist (gen) / n;
+    for (std::size_t i = 0; i != n; ++i)
+        m[i][i] += (i % 2) ? 1.0 : 1.5;
+
+    auto factors = m;
+    std::vector<std::size_t> perm (n);
+    const int sign = yLab::detail::lu_decompose (n, factors.data(), n, perm.data());
+    const double expected = yLab::detail::lu_determinant (n, factors.data(), n, perm.data(), sign);
+
+    EXPECT_NEAR (m.determinant() / expected, 1.0, 1e-9);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "matrix.hpp"
+
+TEST (Views, Blocks_And_Ranges)
+{
+    yLab::Matrix<int> m = {{1,  2,  3,  4},
+                           {5,  6,  7,  8},
+                           {9, 10, 11, 12}};
+
+    auto block = m.block (1, 1, 2, 2);
+    EXPECT_EQ (block.n_rows(), 2);
+    EXPECT_EQ (block[1][0], 10);
+    EXPECT_TRUE (block == (yLab::Matrix<int>{{6, 7}, {10, 11}}));
+
+    EXPECT_TRUE (m.row_range (1, 2) == (yLab::Matrix<int>{{5, 6, 7, 8}}));
+    EXPECT_TRUE (m.col_range (3, 4) == (yLab::Matrix<int>{{4}, {8}, {12}}));
+    EXPECT_TRUE (m.transposed().block (2, 0, 2, 2) == (yLab::Matrix<int>{{3, 7}, {4, 8}}));
+
+    block[0][1] = 0;
+    EXPECT_EQ (m[1][2], 0);
+
+    yLab::Const_Matrix_View<int> const_view = block;
+    EXPECT_EQ (const_view (0, 1), 0);
+
+    EXPECT_THROW (m.block (2, 2, 2, 1), yLab::Undef_Block);
+    EXPECT_THROW (m.row_range (2, 1), yLab::Undef_Block);
+}
+
+TEST (Views, Arithmetics)
+{
+    yLab::Matrix<int> m = {{1, 2},
+                           {3, 4}};
+
+    yLab::Matrix<int> sum = m + m.transposed();
+    EXPECT_TRUE (sum == (yLab::Matrix<int>{{2, 5}, {5, 8}}));
+
+    // The right-hand side reads elements which are overwritten
+    m = m.transposed() * 2;
+    EXPECT_TRUE (m == (yLab::Matrix<int>{{2, 6}, {4, 8}}));
+
+    m += m.transposed();
+    EXPECT_TRUE (m == (yLab::Matrix<int>{{4, 10}, {10, 16}}));
+
+    m.row_range (1, 2).assign (m.row_range (0, 1));
+    EXPECT_TRUE (m == (yLab::Matrix<int>{{4, 10}, {4, 10}}));
+
+    yLab::Matrix<int> n = {{1, 2},
+                           {3, 4}};
+    n.transposed().assign (n);
+    EXPECT_TRUE (n == (yLab::Matrix<int>{{1, 3}, {2, 4}}));
+    EXPECT_THROW (n.row_range (0, 1).assign (n), yLab::Undef_Assignment);
+
+    m.col_range (1, 2) -= m.col_range (0, 1);
+    m.row_range (1, 2) *= 3;
+    EXPECT_TRUE (m == (yLab::Matrix<int>{{4, 6}, {12, 18}}));
+
+    std::ostringstream os;
+    os << m.col_range (1, 2);
+    EXPECT_EQ (os.str(), "6\n18\n");
+}
+
+TEST (Views, Product_And_Determinant)
+{
+    yLab::Matrix<double> m {40, 50};
+    for (std::size_t i = 0; i != m.n_rows(); ++i)
+        for (std::size_t j = 0; j != m.n_cols(); ++j)
+            m[i][j] = static_cast<double>((i * 3 + j * 5) % 7) - 3.0;
+
+    auto m_T = m;
+    m_T.transpose();
+
+    EXPECT_TRUE (product (m, m.transposed()) == product (m, m_T));
+    EXPECT_TRUE (product (m.transposed(), m) == product (m_T, m));
+    EXPECT_TRUE (product (yLab::execution::par, m.transposed(), m) == product (m_T, m));
+
+    yLab::Matrix<double> block = m.block (5, 10, 20, 30);
+    yLab::Matrix<double> block_T = m.block (5, 10, 20, 30).transposed();
+    EXPECT_TRUE (product (m.block (5, 10, 20, 30), block_T) == product (block, block_T));
+
+    yLab::Matrix<int> small = {{2, 0, 1},
+                               {1, 3, 2},
+                               {1, 1, 1}};
+    EXPECT_EQ (small.block (0, 0, 2, 2).determinant(), 6);
+    EXPECT_EQ (small.transposed().determinant(), small.determinant());
+    EXPECT_THROW (small.row_range (0, 2).determinant(), yLab::Undef_Det);
+
+    // A symmetric block with a positive diagonal which isn't positive definite: the elements
+    // of the view are copied again after Cholesky decomposition fails
+    yLab::Matrix<double> indefinite = {{9, 9, 9, 9},
+                                       {9, 1, 2, 0},
+                                       {9, 2, 1, 0},
+                                       {9, 0, 0, 3}};
+    EXPECT_NEAR (indefinite.block (1, 1, 3, 3).determinant(), -9.0, 1e-12);
+    EXPECT_NEAR (indefinite.block (1, 1, 3, 3).transposed().determinant(), -9.0, 1e-12);
+}